@@ -0,0 +1,177 @@
+#ifndef VEHICLE_FOOTPRINT_HPP
+#define VEHICLE_FOOTPRINT_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace astar {
+
+    // the vehicle body as a line of equal circles along the heading, in the rear axle frame
+    // the offsets are computed once from the vehicle dimensions and live inside the object,
+    // so a collision query doesn't touch the heap
+    // the rotated offsets are tabulated for each heading bin, so a collision query doesn't need any trig
+    class VehicleFootprint {
+
+        private:
+
+            // PRIVATE ATTRIBUTES
+
+            // the rotated circle offsets, (x, y) pairs for each circle in each heading bin
+            std::vector<double> table;
+
+            // the same offsets in single precision lanes, all the x values then all the y values in each heading bin
+            // the unused lanes repeat the first circle, so a batch kernel can always load four circles
+            std::vector<float> lanes;
+
+            // PRIVATE METHODS
+
+            // tabulate the rotated offsets
+            void BuildTable() {
+
+                table.resize(HeadingBins * MaxCircles * 2);
+                lanes.resize(HeadingBins * MaxCircles * 2);
+
+                // the largest offset
+                double max_offset = 0.0;
+
+                for (unsigned int i = 0; i < size; ++i) {
+
+                    max_offset = std::max(max_offset, std::fabs(offsets[i]));
+
+                }
+
+                for (unsigned int b = 0; b < HeadingBins; ++b) {
+
+                    // the bin heading
+                    double heading = b * (2.0 * M_PI / HeadingBins);
+                    double c = std::cos(heading), s = std::sin(heading);
+
+                    // the bin row
+                    double *row = &table[b * MaxCircles * 2];
+
+                    // the bin lanes
+                    float *lane = &lanes[b * MaxCircles * 2];
+
+                    for (unsigned int i = 0; i < size; ++i) {
+
+                        row[2 * i] = c * offsets[i];
+                        row[2 * i + 1] = s * offsets[i];
+
+                    }
+
+                    for (unsigned int i = 0; i < MaxCircles; ++i) {
+
+                        lane[i] = row[2 * (i < size ? i : 0)];
+                        lane[MaxCircles + i] = row[2 * (i < size ? i : 0) + 1];
+
+                    }
+
+                }
+
+                // the chord between a heading and the closest bin, at the farthest circle
+                heading_error = 2.0 * max_offset * std::sin(M_PI / (2.0 * HeadingBins));
+
+                // the farthest circle
+                reach = max_offset;
+
+            }
+
+        public:
+
+            // the maximum number of circles
+            static const unsigned int MaxCircles = 8;
+
+            // the number of heading bins, must be a power of two
+            static const unsigned int HeadingBins = 1024;
+
+            // PUBLIC ATTRIBUTES
+
+            // the circle center offsets along the vehicle heading, in the collision check order:
+            // the front and rear circles sweep the largest area when the vehicle turns, so they come first
+            double offsets[MaxCircles];
+
+            // how many circles
+            unsigned int size;
+
+            // the circle radius
+            double radius;
+
+            // the largest circle displacement caused by the heading discretization
+            // the collision checks add it to the circle radius, it covers the center displacement
+            // but a displaced center may still fall in a neighbor cell, like any cell rounding
+            double heading_error;
+
+            // the farthest circle center from the rear axle
+            double reach;
+
+            // PUBLIC METHODS
+
+            // basic constructor, the old hard coded footprint
+            VehicleFootprint() : table(), lanes(), size(4), radius(1.5), heading_error(0.0), reach(0.0) {
+
+                offsets[0] = 3.00;
+                offsets[1] = -0.36;
+                offsets[2] = 1.88;
+                offsets[3] = 0.76;
+
+                // the heading table
+                BuildTable();
+
+            }
+
+            // spread the circles along the vehicle length
+            // the rear overhang is the distance between the rear car and the rear axle
+            void Build(double length, double rear_overhang, unsigned int circles, double r) {
+
+                // the circle limits
+                size = 0 < circles ? (MaxCircles < circles ? MaxCircles : circles) : 1;
+                radius = r;
+
+                // each circle covers the same slice of the vehicle length
+                double step = length / size;
+                double first = step * 0.5 - rear_overhang;
+
+                // the outermost circles first, then move inwards
+                for (unsigned int i = 0, front = size - 1, rear = 0; i < size; ++i) {
+
+                    offsets[i] = first + step * (0 == (i & 1) ? front-- : rear++);
+
+                }
+
+                // the heading table
+                BuildTable();
+
+            }
+
+            // get the heading bin closest to a given orientation, any orientation value is accepted
+            unsigned int HeadingBin(double orientation) const {
+
+                // the bin count is a power of two, so the mask wraps the negative values too
+                return static_cast<unsigned int>(static_cast<long>(std::floor(orientation * (HeadingBins / (2.0 * M_PI)) + 0.5))) & (HeadingBins - 1);
+
+            }
+
+            // get the rotated circle offsets for a given orientation, (x, y) pairs in the check order
+            const double* GetRotatedOffsets(double orientation) const {
+
+                return &table[HeadingBin(orientation) * MaxCircles * 2];
+
+            }
+
+            // get the rotated circle offsets lanes for a given orientation, MaxCircles x values followed by MaxCircles y values
+            const float* GetRotatedLanes(double orientation) const {
+
+                return &lanes[HeadingBin(orientation) * MaxCircles * 2];
+
+            }
+
+    };
+
+    // define the general footprint references and pointers
+    typedef VehicleFootprint* VehicleFootprintPtr;
+    typedef VehicleFootprint& VehicleFootprintRef;
+
+}
+
+#endif
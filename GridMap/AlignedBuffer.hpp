@@ -0,0 +1,141 @@
+#ifndef ALIGNED_BUFFER_HPP
+#define ALIGNED_BUFFER_HPP
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+
+namespace astar {
+
+    // a single contiguous and aligned block of elements, used as a row-stride grid storage
+    // the memory is reallocated only when the number of elements changes
+    template<typename T, std::size_t Alignment = 64>
+    class AlignedBuffer {
+
+        // the elements are never destroyed one by one
+        static_assert(std::is_trivially_destructible<T>::value, "AlignedBuffer requires trivially destructible elements");
+
+        private:
+
+            // PRIVATE ATTRIBUTES
+
+            // the elements
+            T *elements;
+
+            // how many elements
+            std::size_t size;
+
+            // PRIVATE METHODS
+
+            // release the current block
+            void Release() {
+
+                std::free(elements);
+
+                elements = nullptr;
+                size = 0;
+
+            }
+
+        public:
+
+            // basic constructor
+            AlignedBuffer() : elements(nullptr), size(0) {}
+
+            // copy constructor
+            AlignedBuffer(const AlignedBuffer &other) : elements(nullptr), size(0) {
+
+                *this = other;
+
+            }
+
+            // basic destructor
+            ~AlignedBuffer() {
+
+                Release();
+
+            }
+
+            // deep copy, the InternalGridMap references are assigned in HybridAstar and CGSmoother
+            AlignedBuffer& operator=(const AlignedBuffer &other) {
+
+                if (this != &other) {
+
+                    // get a block with the same size
+                    Resize(other.size);
+
+                    // copy the elements
+                    std::copy(other.elements, other.elements + other.size, elements);
+
+                }
+
+                return *this;
+
+            }
+
+            // resize the buffer, all the elements are set to the default value
+            void Resize(std::size_t n) {
+
+                if (n != size) {
+
+                    // remove the old block
+                    Release();
+
+                    if (0 < n) {
+
+                        void *block = nullptr;
+
+                        // get a new aligned block
+                        if (0 != posix_memalign(&block, Alignment, n * sizeof(T))) {
+
+                            throw std::bad_alloc();
+
+                        }
+
+                        elements = static_cast<T*>(block);
+                        size = n;
+
+                    }
+
+                }
+
+                // build the elements
+                std::uninitialized_fill(elements, elements + size, T());
+
+            }
+
+            // set all the elements to a given value
+            void Fill(const T &value) {
+
+                std::fill(elements, elements + size, value);
+
+            }
+
+            // swap the blocks of two buffers
+            void Swap(AlignedBuffer &other) {
+
+                std::swap(elements, other.elements);
+                std::swap(size, other.size);
+
+            }
+
+            // direct access
+            T& operator[](std::size_t i) { return elements[i]; }
+
+            // direct access, const version
+            const T& operator[](std::size_t i) const { return elements[i]; }
+
+            // get the raw pointer
+            T* Data() { return elements; }
+
+            // how many elements
+            std::size_t Size() const { return size; }
+
+    };
+
+}
+
+#endif
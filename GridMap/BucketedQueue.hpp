@@ -7,13 +7,14 @@
 #define BUCKETED_PRIORITY_QUEUE_HPP
 
 #include <vector>
-#include <set>
-#include <queue>
-#include <assert.h>
-#include <map>
+#include <utility>
+#include <algorithm>
 
 #include "GridCellIndex.hpp"
 
+// the default number of direct buckets, squared distances up to 128 cells
+#define BUCKETED_QUEUE_DEFAULT_SIZE (1 << 14)
+
 namespace astar {
 
     template <typename T>
@@ -21,32 +22,74 @@ namespace astar {
 
         private:
 
+            // a single bucket, the elements are popped in FIFO order
+            class Bucket {
+
+                public:
+
+                    // the elements
+                    std::vector<T> elements;
+
+                    // the next element to pop
+                    unsigned int head;
+
+                    // basic constructor
+                    Bucket() : elements(), head(0) {}
+
+            };
+
+            // define an overflow entry
+            typedef std::pair<int, T> OverflowEntry;
+
             // how many elements
             int count;
 
-            // define a bucket map
-            typedef std::map<int, std::queue<T> > BucketType;
+            // how many elements inside the direct buckets
+            int direct_count;
+
+            // the direct buckets, indexed by the priority itself
+            // the memory is kept across the updates, so there's no allocation in steady state
+            std::vector<Bucket> buckets;
 
-            // the internal buckets
-            BucketType buckets;
+            // the lowest direct bucket that may be non empty
+            unsigned int cursor;
 
-            // define a custom iterator name
-            typename BucketType::iterator nextPop;
+            // the priorities outside the direct buckets range (far away cells and the INT_MAX raise entries)
+            // it's a min heap over the priority, the order among equal priorities is not kept
+            std::vector<OverflowEntry> overflow;
+
+            // the overflow heap comparator
+            class OverflowCompare {
+
+                public:
+
+                    bool operator()(const OverflowEntry &a, const OverflowEntry &b) const { return a.first > b.first; }
+
+            };
 
         public:
 
             // basic constructor
-            BucketPrioQueue()
+            BucketPrioQueue(unsigned int size = BUCKETED_QUEUE_DEFAULT_SIZE) : count(0), direct_count(0), buckets(0 < size ? size : 1), cursor(0), overflow()
             {
                 Clear();
             }
 
-            // delete the internal buckets
+            // delete all the elements, the memory is kept
             void Clear()
             {
-                buckets.clear();
+                // the empty buckets are skipped
+                for (unsigned int i = cursor; 0 < direct_count && i < buckets.size(); ++i)
+                {
+                    direct_count -= buckets[i].elements.size() - buckets[i].head;
+                    buckets[i].elements.clear();
+                    buckets[i].head = 0;
+                }
+
+                overflow.clear();
                 count = 0;
-                nextPop = buckets.end();
+                direct_count = 0;
+                cursor = buckets.size();
             }
 
             //! Checks whether the Queue is empty
@@ -55,32 +98,71 @@ namespace astar {
             //! push an element
             void Push(int prio, T t)
             {
-                buckets[prio].push(t);
-                if (nextPop == buckets.end() || prio < nextPop->first) nextPop = buckets.find(prio);
+                if (0 <= prio && prio < (int) buckets.size())
+                {
+                    // save the element in the direct bucket
+                    buckets[prio].elements.push_back(t);
+
+                    // the pushes are not monotone, the cursor goes back if needed
+                    if (prio < (int) cursor) cursor = prio;
+
+                    direct_count++;
+                }
+                else
+                {
+                    // save the element in the overflow heap
+                    overflow.push_back(OverflowEntry(prio, t));
+                    std::push_heap(overflow.begin(), overflow.end(), OverflowCompare());
+                }
+
                 count++;
             }
-            
+
             //! return and pop the element with the lowest squared distance */
             T Pop()
             {
-                while (nextPop!=buckets.end() && nextPop->second.empty()) ++nextPop;
+                count--;
 
-                T p = nextPop->second.front();
-                nextPop->second.pop();
-                if (nextPop->second.empty())
+                if (0 < direct_count)
                 {
-                    typename BucketType::iterator it = nextPop;
-                    nextPop++;
-                    buckets.erase(it);
+                    // find the first non empty bucket
+                    while (buckets[cursor].head == buckets[cursor].elements.size()) ++cursor;
+
+                    Bucket &bucket(buckets[cursor]);
+
+                    T p = bucket.elements[bucket.head++];
+
+                    // an emptied bucket is reset but keeps its capacity
+                    if (bucket.head == bucket.elements.size())
+                    {
+                        bucket.elements.clear();
+                        bucket.head = 0;
+                    }
+
+                    direct_count--;
+                    return p;
                 }
 
-                count--;
+                // the overflow elements come after all the direct ones
+                std::pop_heap(overflow.begin(), overflow.end(), OverflowCompare());
+                T p = overflow.back().second;
+                overflow.pop_back();
+
                 return p;
             }
 
             int Size() { return count; }
             int GetNumBuckets() { return buckets.size(); }
-            int GetTopPriority() { return nextPop->first; }
+            int GetTopPriority()
+            {
+                if (0 < direct_count)
+                {
+                    while (buckets[cursor].head == buckets[cursor].elements.size()) ++cursor;
+                    return cursor;
+                }
+
+                return overflow.front().first;
+            }
     };
 }
 
@@ -0,0 +1,283 @@
+// the batch collision kernel against the per child collision checks, and the compact cost map update against the full map one
+// g++ -std=c++11 -O2 -I.. CollisionCheckerTests.cpp InternalGridMap.cpp GVDLau.cpp ../VehicleModel/VehicleModel.cpp ../Entities/Circle.cpp ../Entities/Pose2D.cpp ../Entities/State2D.cpp ../ReedsShepp/ReedsSheppActionSet.cpp ../PathFinding/HybridAstar/HybridAstarNode.cpp
+// ./a.out <pgm map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "InternalGridMap.hpp"
+#include "../VehicleModel/VehicleModel.hpp"
+
+// load the PGM file
+void loadPGM(std::istream &is, int *sizeX, int *sizeY, std::vector<double> &map)
+{
+	std::string tag;
+
+	is >> tag;
+	if (tag!="P5")
+	{
+		std::cerr << "Awaiting 'P5' in pgm header, found " << tag << std::endl;
+		exit(-1);
+	}
+
+	while (is.peek()==' ' || is.peek()=='\n') is.ignore();
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> *sizeX;
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> *sizeY;
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> tag;
+	if (tag!="255")
+	{
+		std::cerr << "Awaiting '255' in pgm header, found " << tag << std::endl;
+		exit(-1);
+	}
+	is.ignore(255, '\n');
+
+	// the carmen maps are column major
+	map.assign((*sizeX) * (*sizeY), 0.0);
+
+	for (int y = *sizeY-1; y >= 0; --y)
+	{
+		for (int x = 0; x < *sizeX; ++x)
+		{
+			int c = is.get();
+
+			// cell is occupied
+			if ((double) c < 255-255*0.2) map[x * (*sizeY) + y] = 1.0;
+
+			if (!is.good())
+			{
+				std::cerr << "Error reading pgm map.\n";
+				exit(-1);
+			}
+		}
+	}
+}
+
+// the elapsed time in nanoseconds
+double ElapsedNanoseconds(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the compact cost map update must build the same grid and voronoi diagram as the full map update
+// the compact grid starts from a shifted copy of the map, so the sparse update must also clear the old obstacles
+void CompactMapCheck(const std::vector<double> &map, int width, int height, double resolution)
+{
+	// the occupied cells as a compact list, the map is column major
+	std::vector<int> rows, cols;
+	std::vector<double> values;
+
+	for (int col = 0; col < width; ++col)
+	{
+		for (int row = 0; row < height; ++row)
+		{
+			if (0.5 < map[col * height + row])
+			{
+				rows.push_back(row);
+				cols.push_back(col);
+				values.push_back(1.0);
+			}
+		}
+	}
+
+	// the previous frame, the map moved by a few cells
+	std::vector<double> previous(map.size(), 0.0);
+
+	for (int col = 0; col < width; ++col)
+	{
+		for (int row = 0; row < height; ++row)
+		{
+			previous[col * height + row] = map[((col + 7) % width) * height + (row + 3) % height];
+		}
+	}
+
+	astar::InternalGridMap full, compact;
+
+	full.UpdateGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), &previous[0]);
+	full.UpdateVoronoiDiagram();
+	full.UpdateGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), const_cast<double*>(&map[0]));
+	full.UpdateVoronoiDiagram();
+
+	compact.UpdateGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), &previous[0]);
+	compact.UpdateVoronoiDiagram();
+	compact.UpdateCompactGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), rows.size(), &rows[0], &cols[0], &values[0]);
+	compact.UpdateVoronoiDiagram();
+
+	unsigned int occupancy_diffs = 0, obstacle_diffs = 0, distance_diffs = 0;
+
+	for (int row = 0; row < height; ++row)
+	{
+		for (int col = 0; col < width; ++col)
+		{
+			unsigned int index = row * width + col;
+
+			occupancy_diffs += (0 < full.grid_map[index].occupancy) != (0 < compact.grid_map[index].occupancy);
+			obstacle_diffs += full.GetGVD()->isObstacle(row, col) != compact.GetGVD()->isObstacle(row, col);
+			distance_diffs += full.GetGVD()->GetObstacleDistance(row, col) != compact.GetGVD()->GetObstacleDistance(row, col);
+		}
+	}
+
+	std::cout << "Compact cost map update, " << rows.size() << " listed cells: " << occupancy_diffs << " occupancy, "
+			  << obstacle_diffs << " voronoi obstacle and " << distance_diffs << " obstacle distance differences, "
+			  << compact.GetGVDMetrics().changed_cells << " changed cells\n";
+}
+
+int main (int argc, char **argv)
+{
+	if (2 != argc)
+	{
+		std::cerr << "usage: " << argv[0] << " <pgm map>\n";
+		exit(-1);
+	}
+
+	std::ifstream is(argv[1]);
+	if (!is.is_open())
+	{
+		std::cerr << "Could not open map file for reading.\n";
+		exit(-1);
+	}
+
+	int width, height;
+	std::vector<double> map;
+
+	loadPGM(is, &width, &height, map);
+	is.close();
+
+	std::cout << "Building the grid map: " << width << "x" << height << " ...\n";
+
+	// the grid map, 0.2 m cells
+	double resolution = 0.2;
+	astar::InternalGridMap grid;
+	grid.UpdateGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), &map[0]);
+	grid.UpdateVoronoiDiagram();
+
+	// the compact cost map handler path
+	CompactMapCheck(map, width, height, resolution);
+
+	// the ford escape parameters
+	astar::VehicleModel vehicle;
+	vehicle.length = 4.425;
+	vehicle.width = 1.806;
+	vehicle.axledist = 2.625;
+	vehicle.rear_car_wheels_dist = 0.96;
+	vehicle.max_wheel_deflection = 0.5337;
+	vehicle.understeer = 0.0015;
+	vehicle.max_curvature = 0.22;
+	vehicle.safety_factor = 1.0;
+	vehicle.Configure();
+
+	// the random expanded nodes
+	const unsigned int N = 200000;
+	std::vector<astar::Pose2D> starts(N);
+	std::vector<astar::Gear> gears(N);
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> x(0.0, width * resolution), y(0.0, height * resolution), t(-M_PI, M_PI);
+
+	for (unsigned int i = 0; i < N; ++i)
+	{
+		starts[i] = astar::Pose2D(x(generator), y(generator), t(generator));
+		gears[i] = 0 == (i & 1) ? astar::ForwardGear : astar::BackwardGear;
+	}
+
+	// the children step length
+	double length = 2.0;
+	double tr = vehicle.min_turn_radius;
+
+	std::vector<unsigned int> circles_mask(N, 0), footprint_mask(N, 0), batch_mask(N, 0);
+
+	std::cout << "Checking " << N << " expanded nodes, " << astar::NumSteering << " children each ...\n";
+
+	// the old path: NextPose, GetVehicleBodyCircles and isSafePlace for each child
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < N; ++i)
+	{
+		for (unsigned int j = 0; j < astar::NumSteering; ++j)
+		{
+			astar::Pose2D child(vehicle.NextPose(starts[i], static_cast<astar::Steer>(j), gears[i], length, tr));
+
+			if (grid.isValidPoint(child.position) && grid.isSafePlace(vehicle.GetVehicleBodyCircles(child), vehicle.safety_factor))
+			{
+				circles_mask[i] |= 1u << j;
+			}
+		}
+	}
+	double circles_time = ElapsedNanoseconds(start) / N;
+
+	// the footprint table path, one child at a time
+	start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < N; ++i)
+	{
+		for (unsigned int j = 0; j < astar::NumSteering; ++j)
+		{
+			astar::Pose2D child(vehicle.NextPose(starts[i], static_cast<astar::Steer>(j), gears[i], length, tr));
+
+			if (grid.isValidPoint(child.position) && grid.isSafePlace(child, vehicle.footprint, vehicle.safety_factor))
+			{
+				footprint_mask[i] |= 1u << j;
+			}
+		}
+	}
+	double footprint_time = ElapsedNanoseconds(start) / N;
+
+	// the batch path, all children at once
+	astar::Pose2D children[astar::NumSteering];
+	start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < N; ++i)
+	{
+		vehicle.NextPoses(starts[i], gears[i], length, tr, children);
+
+		unsigned int mask = grid.CheckPoses(children, astar::NumSteering, vehicle.footprint, vehicle.safety_factor);
+
+		for (unsigned int j = 0; j < astar::NumSteering; ++j)
+		{
+			if ((mask & (1u << j)) && grid.isValidPoint(children[j].position))
+			{
+				batch_mask[i] |= 1u << j;
+			}
+		}
+	}
+	double batch_time = ElapsedNanoseconds(start) / N;
+
+	// the batch propagation must match NextPose
+	double max_position_error = 0.0, max_orientation_error = 0.0;
+	for (unsigned int i = 0; i < N; ++i)
+	{
+		vehicle.NextPoses(starts[i], gears[i], length, tr, children);
+
+		for (unsigned int j = 0; j < astar::NumSteering; ++j)
+		{
+			astar::Pose2D child(vehicle.NextPose(starts[i], static_cast<astar::Steer>(j), gears[i], length, tr));
+
+			max_position_error = std::max(max_position_error, child.position.Distance(children[j].position));
+			max_orientation_error = std::max(max_orientation_error, std::fabs(child.orientation - children[j].orientation));
+		}
+	}
+
+	// compare the decisions
+	unsigned int safe = 0, footprint_diffs = 0, batch_diffs = 0;
+	for (unsigned int i = 0; i < N; ++i)
+	{
+		for (unsigned int j = 0; j < astar::NumSteering; ++j)
+		{
+			unsigned int bit = 1u << j;
+
+			safe += (circles_mask[i] & bit) ? 1 : 0;
+			footprint_diffs += (circles_mask[i] & bit) != (footprint_mask[i] & bit) ? 1 : 0;
+			batch_diffs += (footprint_mask[i] & bit) != (batch_mask[i] & bit) ? 1 : 0;
+		}
+	}
+
+	std::cout << "NextPoses vs NextPose, max position error: " << max_position_error << " max orientation error: " << max_orientation_error << "\n";
+	std::cout << "Safe children with the body circles: " << safe << " of " << N * astar::NumSteering << "\n";
+	std::cout << "  body circles per node:    " << circles_time << " ns\n";
+	std::cout << "  footprint table per node: " << footprint_time << " ns, " << footprint_diffs << " decisions differ from the body circles\n";
+	std::cout << "  batch kernel per node:    " << batch_time << " ns, " << batch_diffs << " decisions differ from the footprint table\n";
+
+	return 0;
+}
@@ -9,19 +9,28 @@
 
 using namespace astar;
 
+// wrap a shifted row or column, the offsets are always smaller than the dimension
+#define GVD_WRAP(v, n) ((v) < (n) ? (v) : (v) - (n))
+
+// the row-stride physical index of a logical cell, i is the row and j is the column
+// the window is toroidal, so the physical rows and columns are rotated by the window offsets
+#define GVD_INDEX(i, j) (GVD_WRAP((unsigned int) (i) + row_offset, height)*width + GVD_WRAP((unsigned int) (j) + col_offset, width))
+
 // basic constructor
 GVDLau::GVDLau() :
-    data(nullptr), next_data(nullptr),
+    dist(), sqdist(), nearest_obstacle(), flags(),
+    voro_dist(), voro_sqdist(), nearest_voro(),
     height(0),
     heightminus1(0),
     width(0),
     widthminus1(0),
+    row_offset(0),
+    col_offset(0),
     alpha(0.2),
     max_dist(20),
     max_sqdist(400),
-    max_double(std::numeric_limits<double>::max()),
-    initialized(false),
-    edges(INT_MAX)
+    max_float(std::numeric_limits<float>::max()),
+    initialized(false)
 {}
 
 // basic destructor
@@ -34,19 +43,29 @@ GVDLau::~GVDLau() {
 // Remove the entire allocated diagram
 void GVDLau::RemoveDiagram() {
 
-    if (nullptr != data) {
-        for (unsigned int i = 0; i < height; ++i) {
-            delete [] data[i];
-        }
-        delete [] data;
-    }
+    dist.Resize(0);
+    sqdist.Resize(0);
+    nearest_obstacle.Resize(0);
+    flags.Resize(0);
+    voro_dist.Resize(0);
+    voro_sqdist.Resize(0);
+    nearest_voro.Resize(0);
 
-    if (nullptr != next_data) {
-        for (unsigned int i = 0; i < height; ++i) {
-            delete [] next_data[i];
-        }
-        delete [] next_data;
-    }
+}
+
+// allocate all the planes with the current dimensions
+void GVDLau::AllocateDiagram() {
+
+    // the number of cells
+    unsigned int size = height * width;
+
+    dist.Resize(size);
+    sqdist.Resize(size);
+    nearest_obstacle.Resize(size);
+    flags.Resize(size);
+    voro_dist.Resize(size);
+    voro_sqdist.Resize(size);
+    nearest_voro.Resize(size);
 
 }
 
@@ -56,6 +75,24 @@ bool GVDLau::isValidIndex(const astar::GridCellIndexRef index) const {
     return (height > index.row && width > index.col);
 }
 
+// get the logical row and column of a given physical flat index
+GridCellIndex GVDLau::FlatToIndex(unsigned int k) const {
+
+    if (UINT_MAX != k) {
+
+        // the physical row and column
+        unsigned int row = k / width;
+        unsigned int col = k % width;
+
+        // undo the window rotation
+        return GridCellIndex(GVD_WRAP(row + height - row_offset, height), GVD_WRAP(col + width - col_offset, width));
+
+    }
+
+    return GridCellIndex(UINT_MAX, UINT_MAX);
+
+}
+
 // get the squared distance between two cells
 int GVDLau::DistanceSquared(const astar::GridCellIndexRef a, const astar::GridCellIndexRef b) {
 
@@ -70,10 +107,7 @@ bool GVDLau::isOccupied(const astar::GridCellIndexRef index) const {
 
     if (isValidIndex(index)) {
 
-        // get the cell reference
-        GVDLau::DataCellRef c(next_data[index.row][index.col]);
-
-        return (index.col == c.nearest_obstacle.col  && index.row == c.nearest_obstacle.row);
+        return isOccupied(GVD_INDEX(index.row, index.col));
 
     }
 
@@ -81,10 +115,10 @@ bool GVDLau::isOccupied(const astar::GridCellIndexRef index) const {
 }
 
 // verify if a given cell is occupied, wich means that the nearest obstacle is the given cell
-// overloaded version
-bool GVDLau::isOccupied(const astar::GridCellIndexRef index, const DataCellRef c) {
+// flat index overloaded version
+bool GVDLau::isOccupied(unsigned int k) const {
 
-    return (index.row == c.nearest_obstacle.row  && index.col == c.nearest_obstacle.col);
+    return k == nearest_obstacle[k];
 
 }
 
@@ -93,10 +127,8 @@ bool GVDLau::isVoroOccupied(const GridCellIndexRef index) {
 
     if (isValidIndex(index)) {
 
-        // get the cell reference
-        GVDLau::DataCellRef c(next_data[index.row][index.col]);
+        return isVoroOccupied(GVD_INDEX(index.row, index.col));
 
-        return (c.nearest_voro.row == index.row && c.nearest_voro.col == index.col);
     }
 
     return false;
@@ -104,85 +136,90 @@ bool GVDLau::isVoroOccupied(const GridCellIndexRef index) {
 }
 
 // verify if a given cell is voro occupied, wich means that the nearest voro is the given cell
-// overloaded version
-bool GVDLau::isVoroOccupied(const GridCellIndexRef index, const DataCellRef c) {
+// flat index overloaded version
+bool GVDLau::isVoroOccupied(unsigned int k) {
 
-    return (c.nearest_voro.row == index.row && c.nearest_voro.col == index.col);
+    return k == nearest_voro[k];
 
 }
 
-// set a given cell as voro
+// set a given cell as voro, it's a source to the voronoi distance map
 void GVDLau::SetVoro(const GridCellIndexRef index) {
 
-    // get the current DataCell
-    GVDLau::DataCellRef s(next_data[index.row][index.col]);
+    // get the flat index
+    unsigned int k = GVD_INDEX(index.row, index.col);
+
+    // it's already a valid source
+    if (k == nearest_voro[k] && !(flags[k] & VoroToRaiseFlag)) {
+        return;
+    }
 
     // update the cell values
-    s.nearest_voro = index;
-    s.voro_dist = 0.0;
-    s.voro_sqdist = 0;
-    s.voro_to_process = true;
-    s.is_corridor = true;
+    nearest_voro[k] = k;
+    voro_dist[k] = 0.0f;
+    voro_sqdist[k] = 0;
+    flags[k] &= ~VoroToRaiseFlag;
+    flags[k] |= VoroToProcessFlag;
 
     // add the current cell to the voro open queue
     voro_open.Push(0, GridCellIndex(index));
 
 }
 
-// unset a voro cell
+// unset a voro cell, the cells pointing to it are raised in the next voronoi distance map update
 void GVDLau::UnsetVoro(const GridCellIndexRef index) {
 
-    // get the current DataCell
-    GVDLau::DataCellRef s(next_data[index.row][index.col]);
+    // get the flat index
+    unsigned int k = GVD_INDEX(index.row, index.col);
 
     // update the cell values
-    s.voro_dist = max_double;
-    s.voro_sqdist = INT_MAX;
-    s.nearest_voro.row = s.nearest_voro.col = UINT_MAX;
-    s.voro_to_raise = true;
-    s.voro_to_process = true;
-    s.is_corridor = true;
+    voro_dist[k] = max_float;
+    voro_sqdist[k] = INT_MAX;
+    nearest_voro[k] = UINT_MAX;
+    flags[k] |= VoroToRaiseFlag | VoroToProcessFlag;
 
     // add the current cell to the voro open queue
-    voro_open.Push(INT_MAX, GridCellIndex(index));
+    // the raised cells have the highest priority, so the whole raise wave ends before the lower one starts
+    // and each cell is lowered only once, in increasing distance order
+    voro_open.Push(0, GridCellIndex(index));
 
 }
 
 // check the voro case
 void GVDLau::CheckVoro(GridCellIndexRef indexS, GridCellIndexRef indexN) {
 
-    // get the actual cells
-    GVDLau::DataCellRef s(next_data[indexS.row][indexS.col]);
-    GVDLau::DataCellRef n(next_data[indexN.row][indexN.col]);
+    // get the flat indexes
+    unsigned int s = GVD_INDEX(indexS.row, indexS.col);
+    unsigned int n = GVD_INDEX(indexN.row, indexN.col);
 
-    if (!isValidIndex(s.nearest_obstacle) || !isValidIndex(n.nearest_obstacle)) return;
+    if (UINT_MAX == nearest_obstacle[s] || UINT_MAX == nearest_obstacle[n]) return;
 
-    // get the nearest obstacle indexes
-    GridCellIndexRef noS(s.nearest_obstacle);
-    GridCellIndexRef noN(n.nearest_obstacle);
+    if ((1 < sqdist[s] || 1 < sqdist[n])) {
 
-    if ((1 < s.sqdist || 1 < n.sqdist)) {
+        // get the nearest obstacle indexes
+        GridCellIndex noS(FlatToIndex(nearest_obstacle[s]));
+        GridCellIndex noN(FlatToIndex(nearest_obstacle[n]));
 
         if (1 < std::abs((int) noS.row - (int) noN.row) || 1 < std::abs((int) noS.col - (int) noN.col)) {
 
             int sObstN = DistanceSquared(indexS, noN);
             int nObstS = DistanceSquared(indexN, noS);
 
-            int sStability = sObstN - s.sqdist;
-            int nStability = nObstS - n.sqdist;
+            int sStability = sObstN - sqdist[s];
+            int nStability = nObstS - sqdist[n];
 
             if (sStability < 0 || nStability < 0)
                 return;
 
             if (sStability <= nStability)
             {
-                s.voro = true;
+                flags[s] |= VoroFlag;
 
                 SetVoro(indexS);
             }
             if (nStability <= sStability)
             {
-                n.voro = true;
+                flags[n] |= VoroFlag;
 
                 SetVoro(indexN);
             }
@@ -202,12 +239,12 @@ void GVDLau::UpdateDistanceMap() {
         int row = index.row;
         int col = index.col;
 
-        // get the current cell
-        GVDLau::DataCellRef s(next_data[row][col]);
+        // get the current flat index
+        unsigned int s = GVD_INDEX(row, col);
 
-        if (!s.to_process) continue;
+        if (!(flags[s] & ToProcessFlag)) continue;
 
-        if (s.to_raise) {
+        if (flags[s] & ToRaiseFlag) {
 
             // raise
             // get the 8 neighbors
@@ -233,27 +270,27 @@ void GVDLau::UpdateDistanceMap() {
                     // valid cell, so let's process
 
                     // get the current neighbor
-                    GVDLau::DataCellRef nc(next_data[nrow][ncol]);
+                    unsigned int n = GVD_INDEX(nrow, ncol);
 
-                    if (nc.is_corridor) {
+                    if (flags[n] & CorridorFlag) {
 
-                        if (UINT_MAX != nc.nearest_obstacle.col && UINT_MAX != nc.nearest_obstacle.row && !nc.to_raise) {
+                        if (UINT_MAX != nearest_obstacle[n] && !(flags[n] & ToRaiseFlag)) {
 
-                            if (!isOccupied(nc.nearest_obstacle, next_data[nc.nearest_obstacle.row][nc.nearest_obstacle.col])) {
+                            if (!isOccupied(nearest_obstacle[n])) {
 
                                 // update the neighbor values
-                                nc.sqdist = INT_MAX;
-                                nc.dist = max_double;
-                                nc.nearest_obstacle.row = nc.nearest_obstacle.col = UINT_MAX;
-                                nc.to_raise = true;
+                                sqdist[n] = INT_MAX;
+                                dist[n] = max_float;
+                                nearest_obstacle[n] = UINT_MAX;
+                                flags[n] |= ToRaiseFlag;
 
                             }
 
                             // set the neighbor to process
-                            nc.to_process = true;
+                            flags[n] |= ToProcessFlag;
 
                             // add to the open queue
-                            open.Push(nc.sqdist, GridCellIndex(nrow, ncol));
+                            open.Push(sqdist[n], GridCellIndex(nrow, ncol));
 
                         }
                     }
@@ -262,14 +299,22 @@ void GVDLau::UpdateDistanceMap() {
             }
 
             // unset the raise flag
-            s.to_raise = false;
+            flags[s] &= ~ToRaiseFlag;
+
+        } else if (UINT_MAX != nearest_obstacle[s] && isOccupied(nearest_obstacle[s])) {
+
+            // the lowered cell is not a voronoi edge anymore, CheckVoro decides it again
+            if (flags[s] & VoroFlag) {
+
+                flags[s] &= ~VoroFlag;
+                UnsetVoro(index);
+
+            }
 
-        } else if (isOccupied(s.nearest_obstacle, next_data[s.nearest_obstacle.row][s.nearest_obstacle.col])) {
+            flags[s] &= ~ToProcessFlag;
 
-            // udpate the current voro values
-            s.voro = false;
-            UnsetVoro(index);
-            s.to_process = false;
+            // the nearest obstacle position, the same for all the neighbors
+            GridCellIndex obstacle(FlatToIndex(nearest_obstacle[s]));
 
             // lower
 
@@ -296,22 +341,22 @@ void GVDLau::UpdateDistanceMap() {
                     // valid cell, so let's process
 
                     // get the neighbor cell
-                    GVDLau::DataCellRef nc(next_data[nrow][ncol]);
+                    unsigned int n = GVD_INDEX(nrow, ncol);
 
-                    if (nc.is_corridor && !nc.to_raise) {
+                    if ((flags[n] & CorridorFlag) && !(flags[n] & ToRaiseFlag)) {
 
                         //
                         GridCellIndex nindex(nrow, ncol);
 
-                        int d = DistanceSquared(s.nearest_obstacle, nindex);
+                        int d = DistanceSquared(obstacle, nindex);
 
-                        if (d < nc.sqdist) {
+                        if (d < sqdist[n]) {
 
                             // update the neighbor values
-                            nc.sqdist = d;
-                            nc.dist = std::sqrt(d);
-                            nc.nearest_obstacle = s.nearest_obstacle;
-                            nc.to_process = true;
+                            sqdist[n] = d;
+                            dist[n] = std::sqrt(d);
+                            nearest_obstacle[n] = nearest_obstacle[s];
+                            flags[n] |= ToProcessFlag;
 
                             // add the current neighbor to the open queue
                             open.Push(d, nindex);
@@ -335,6 +380,7 @@ void GVDLau::UpdateDistanceMap() {
 }
 
 // update the voronoi distance map
+// the same raise and lower brushfire used by the obstacle distance map, the sources are the voronoi edge cells
 void GVDLau::UpdateVoronoiMap() {
 
     while (!voro_open.Empty()) {
@@ -346,121 +392,118 @@ void GVDLau::UpdateVoronoiMap() {
         int row = index.row;
         int col = index.col;
 
-        // get the actual DataCell
-        GVDLau::DataCellRef s(next_data[row][col]);
+        // get the actual flat index
+        unsigned int s = GVD_INDEX(row, col);
 
-        if (s.voro_to_process) {
+        if (!(flags[s] & VoroToProcessFlag)) continue;
 
-            if (s.voro_to_raise) {
+        if (flags[s] & VoroToRaiseFlag) {
 
-                // raise
-
-                // get the 8 neighbors
-                for (int drow = -1; drow < 2; ++drow) {
-
-                    // get the vertical displacement
-                    int nrow = row + drow;
-
-                    // verify the limits
-                    if (0 >= nrow || heightminus1 <= nrow) continue;
+            // raise
 
-                    for (int dcol = -1; dcol < 2; ++dcol) {
+            // get the 8 neighbors
+            for (int drow = -1; drow < 2; ++drow) {
 
-                        // the current cell
-                        if (!drow && !dcol) continue;
+                // get the vertical displacement
+                int nrow = row + drow;
 
-                        // get the horizontal displacement
-                        int ncol = col + dcol;
+                // verify the limits
+                if (0 > nrow || heightminus1 < nrow) continue;
 
-                        // verify the limits
-                        if (0 >= ncol || widthminus1 <= ncol) continue;
+                for (int dcol = -1; dcol < 2; ++dcol) {
 
-                        // valid cell, let's process
+                    // the current cell
+                    if (!drow && !dcol) continue;
 
-                        // get the actual cell
-                        GVDLau::DataCellRef nc(next_data[nrow][ncol]);
+                    // get the horizontal displacement
+                    int ncol = col + dcol;
 
-                        if (nc.is_corridor) {
+                    // verify the limits
+                    if (0 > ncol || widthminus1 < ncol) continue;
 
-                            if (UINT_MAX != nc.nearest_voro.col && !nc.voro_to_raise) {
+                    // valid cell, let's process
 
-                                if (!isVoroOccupied(nc.nearest_voro, next_data[nc.nearest_voro.row][nc.nearest_voro.col])) {
+                    // get the actual cell
+                    unsigned int n = GVD_INDEX(nrow, ncol);
 
-                                    // update the neighbor values
-                                    nc.dist = max_double;
-                                    nc.sqdist = INT_MAX;
-                                    nc.nearest_voro.row = nc.nearest_voro.col = -1;
-                                    nc.voro_to_raise = true;
+                    if ((flags[n] & CorridorFlag) && UINT_MAX != nearest_voro[n] && !(flags[n] & VoroToRaiseFlag)) {
 
-                                }
+                        if (!isVoroOccupied(nearest_voro[n])) {
 
-                                // set the voro to process flag
-                                nc.voro_to_process = true;
+                            // the neighbor source was removed, update the neighbor values
+                            voro_dist[n] = max_float;
+                            voro_sqdist[n] = INT_MAX;
+                            nearest_voro[n] = UINT_MAX;
+                            flags[n] |= VoroToRaiseFlag;
 
-                                // add the current neighbor index to the voro open queue
-                                voro_open.Push(nc.voro_sqdist, GridCellIndex(nrow, ncol));
+                        }
 
-                            }
+                        // set the voro to process flag
+                        flags[n] |= VoroToProcessFlag;
 
-                        }
+                        // add the current neighbor index to the voro open queue, the raised ones first
+                        voro_open.Push((flags[n] & VoroToRaiseFlag) ? 0 : voro_sqdist[n], GridCellIndex(nrow, ncol));
 
                     }
 
                 }
 
-                // update the voro to raise flag
-                s.voro_to_raise = false;
+            }
 
-            } else if (isVoroOccupied(s.nearest_voro)) {
+            // update the voro to raise flag
+            flags[s] &= ~VoroToRaiseFlag;
 
-                // reset the voro_to_process flag
-                s.voro_to_process = false;
+        } else if (UINT_MAX != nearest_voro[s] && isVoroOccupied(nearest_voro[s])) {
 
-                // lower
+            // reset the voro_to_process flag
+            flags[s] &= ~VoroToProcessFlag;
 
-                // get the 8 neighbors
-                for (int drow = -1; drow < 2; ++drow) {
+            // the nearest voro position, the same for all the neighbors
+            GridCellIndex voro(FlatToIndex(nearest_voro[s]));
 
-                    // get the vertical displacement
-                    int nrow = row + drow;
+            // lower
 
-                    // verify the limits
-                    if (0 >= nrow || heightminus1 <= nrow) continue;
+            // get the 8 neighbors
+            for (int drow = -1; drow < 2; ++drow) {
 
-                    for (int dcol = -1; dcol < 2; ++dcol) {
+                // get the vertical displacement
+                int nrow = row + drow;
 
-                        // the current cell
-                        if (!drow && !dcol) continue;
+                // verify the limits
+                if (0 > nrow || heightminus1 < nrow) continue;
 
-                        // get the horizontal displacement
-                        int ncol = col + dcol;
+                for (int dcol = -1; dcol < 2; ++dcol) {
 
-                        // verify the limits
-                        if (0 >= ncol || widthminus1 <= ncol) continue;
+                    // the current cell
+                    if (!drow && !dcol) continue;
 
-                        // valid cell, let's process
+                    // get the horizontal displacement
+                    int ncol = col + dcol;
 
-                        // get the actual neighbor cell
-                        GVDLau::DataCellRef nc(next_data[nrow][ncol]);
+                    // verify the limits
+                    if (0 > ncol || widthminus1 < ncol) continue;
 
-                        if (nc.is_corridor && !nc.voro_to_raise) {
+                    // valid cell, let's process
 
-                            GridCellIndex ngc(nrow, ncol);
+                    // get the actual neighbor cell
+                    unsigned int n = GVD_INDEX(nrow, ncol);
 
-                            int d = DistanceSquared(s.nearest_voro, ngc);
+                    if ((flags[n] & CorridorFlag) && !(flags[n] & VoroToRaiseFlag)) {
 
-                            if (d < nc.voro_sqdist) {
+                        GridCellIndex ngc(nrow, ncol);
 
-                                // update the neighbor values
-                                nc.voro_sqdist = d;
-                                nc.voro_dist = std::sqrt(d);
-                                nc.nearest_voro = s.nearest_voro;
-                                nc.voro_to_process = true;
+                        int d = DistanceSquared(voro, ngc);
 
-                                // add the current cell to the voro open queue
-                                voro_open.Push(d, ngc);
+                        if (d < voro_sqdist[n]) {
 
-                            }
+                            // update the neighbor values
+                            voro_sqdist[n] = d;
+                            voro_dist[n] = std::sqrt(d);
+                            nearest_voro[n] = nearest_voro[s];
+                            flags[n] |= VoroToProcessFlag;
+
+                            // add the current cell to the voro open queue
+                            voro_open.Push(d, ngc);
 
                         }
 
@@ -476,49 +519,22 @@ void GVDLau::UpdateVoronoiMap() {
 
 }
 
-// update the path cost map
-void GVDLau::UpdatePathCostMap() {
-
-    for (unsigned int r = 0; r < height; ++r) {
+// get the path cost of a given cell, computed from the distance fields
+double GVDLau::PathCost(unsigned int k) const {
 
-        for (unsigned int c = 0; c < width; ++c) {
+    // syntactic sugar
+    double d = dist[k];
+    double vd = voro_dist[k];
 
-            // get the current data cell
-            GVDLau::DataCellRef s(next_data[r][c]);
+    if (max_dist <= d || max_float == voro_dist[k]) {
 
-            // get the nearest voro index
-            PointT<unsigned int, 2> find({r, c});
-
-            // get the closest index
-            PointT<unsigned int, 2> found(edges.Nearest(find));
-
-            // set the nearest voro index
-            s.nearest_voro.row = found[0];
-            s.nearest_voro.col = found[1];
-
-            int dr = (int) found[0] - (int) r;
-            int dc = (int) found[1] - (int) c;
-
-            // set the voro dist
-            s.voro_sqdist = dr*dr + dc*dc;
-            s.voro_dist = std::sqrt(s.voro_sqdist);
-
-            if (max_dist <= s.dist || max_double == s.voro_dist) {
-
-                // std::cout << "menor " << max_dist << " < " << s.dist << "\n";
-                s.path_cost = 0.0;
-
-            } else {
-
-                // save the voronoi potential field
-                s.path_cost = (alpha / (alpha + s.dist)) * (s.voro_dist / (s.dist + s.voro_dist)) * ((max_dist - s.dist) * (max_dist - s.dist) / (max_sqdist));
-
-            }
-
-        }
+        return 0.0;
 
     }
 
+    // the voronoi potential field
+    return (alpha / (alpha + d)) * (vd / (d + vd)) * ((max_dist - d) * (max_dist - d) / (max_sqdist));
+
 }
 
 // Initialize the GVD
@@ -535,17 +551,8 @@ void GVDLau::InitializeEmpty(unsigned int h, unsigned int w) {
         width = w;
         widthminus1 = ((int) w) - 1;
 
-        // allocate a new diagram
-        data = new GVDLau::DataCellPtr[height];
-
-        for (unsigned int i = 0; i < height; ++i) {
-            data[i] = new GVDLau::DataCell[width];
-        }
-
-        next_data = new GVDLau::DataCellPtr[height];
-        for (unsigned int j = 0; j < height; ++j) {
-            next_data[j] = new GVDLau::DataCell[width];
-        }
+        // allocate a new diagram, a single block for each plane
+        AllocateDiagram();
 
     }
 
@@ -570,17 +577,8 @@ void GVDLau::InitializeMap(unsigned int h, unsigned int w, bool **map) {
             width = w;
             widthminus1 = ((int) w) - 1;
 
-            // allocate a new diagram
-            data = new GVDLau::DataCellPtr[height];
-
-            for (unsigned int i = 0; i < height; ++i) {
-                data[i] = new GVDLau::DataCell[width];
-            }
-
-            next_data = new GVDLau::DataCellPtr[height];
-            for (unsigned int i = 0; i < height; ++i) {
-                next_data[i] = new GVDLau::DataCell[width];
-            }
+            // allocate a new diagram, a single block for each plane
+            AllocateDiagram();
         }
 
         // copy the given map
@@ -590,13 +588,10 @@ void GVDLau::InitializeMap(unsigned int h, unsigned int w, bool **map) {
 
                 if (map[r][c]) {
 
-                    // get the current DataCell
-                    GVDLau::DataCellRef s(next_data[r][c]);
+                    // get the current flat index
+                    unsigned int k = GVD_INDEX(r, c);
 
-                    // build the current index
-                    GridCellIndex index(r, c);
-
-                    if (!isOccupied(index, s)) {
+                    if (!isOccupied(k)) {
 
                         bool isSurrounded = true;
 
@@ -631,16 +626,20 @@ void GVDLau::InitializeMap(unsigned int h, unsigned int w, bool **map) {
                         // is it surrounded?
                         if (isSurrounded) {
 
-                            // update the grid cell values
-                            s.dist = 0.0;
-                            s.sqdist = 0;
-                            s.voro = false;
-                            s.to_raise = false;
-                            s.to_process = false;
-                            s.voro_to_raise = false;
-                            s.voro_to_process = false;
-                            s.nearest_obstacle = index;
-                            s.is_corridor = false;
+                            // a surrounded cell is not a voronoi edge
+                            if (flags[k] & VoroFlag) {
+
+                                GridCellIndex index(r, c);
+
+                                UnsetVoro(index);
+
+                            }
+
+                            // update the grid cell values, all the flags are cleared but the voro ones
+                            dist[k] = 0.0f;
+                            sqdist[k] = 0;
+                            nearest_obstacle[k] = k;
+                            flags[k] &= VoroToRaiseFlag | VoroToProcessFlag;
 
                         } else {
                             SetObstacle(r, c);
@@ -655,83 +654,287 @@ void GVDLau::InitializeMap(unsigned int h, unsigned int w, bool **map) {
 // restart the GVD
 void GVDLau::RestartVoronoiDiagram() {
 
+    // the window is not rotated anymore
+    row_offset = col_offset = 0;
+
+    // the old queued cells are not valid anymore
+    open.Clear();
+    voro_open.Clear();
+
     // clear the entire diagram
-    GVDLau::DataCell c;
-    c.sqdist = INT_MAX;
-    c.dist = max_double;
-    c.nearest_obstacle.row = c.nearest_obstacle.col = UINT_MAX;
-    c.to_raise = c.to_process = false;
-    c.voro = true;
-    c.voro_sqdist = INT_MAX;
-    c.voro_dist = max_double;
-    c.nearest_voro.row = c.nearest_voro.col = UINT_MAX;
-    c.voro_to_raise = c.voro_to_process = false;
-    c.path_cost = 0;
-    c.is_corridor = true;
-
-    for (unsigned int i = 0; i < height; ++i) {
-
-        for (unsigned int j = 0; j < width; ++j) {
-            data[i][j] = c;
-            next_data[i][j] = c;
+    dist.Fill(max_float);
+    sqdist.Fill(INT_MAX);
+    nearest_obstacle.Fill(UINT_MAX);
+    flags.Fill(VoroFlag | CorridorFlag);
+
+    // without obstacles, every cell is a voronoi edge and its own voro source
+    voro_dist.Fill(0.0f);
+    voro_sqdist.Fill(0);
+
+    for (unsigned int k = 0; k < nearest_voro.Size(); ++k) {
+
+        nearest_voro[k] = k;
+
+    }
+
+}
+
+// get the rows or columns leaving the window, in the old coordinates, and the ones entering it, in the new coordinates
+void GVDLau::GetWindowStrips(int shift, unsigned int n, unsigned int &leaving_begin, unsigned int &leaving_end, unsigned int &entering_begin, unsigned int &entering_end) const {
+
+    if (0 < shift) {
+
+        // the window moves forward, the first ones are leaving
+        leaving_begin = 0;
+        leaving_end = shift;
+        entering_begin = n - shift;
+        entering_end = n;
+
+    } else {
+
+        // the window moves backward, the last ones are leaving
+        leaving_begin = n + shift;
+        leaving_end = n;
+        entering_begin = 0;
+        entering_end = -shift;
+
+    }
+
+}
+
+// reset a given cell to the restart values, the cell is a new voro source
+void GVDLau::ResetCell(unsigned int row, unsigned int col) {
+
+    // get the physical index
+    unsigned int k = GVD_INDEX(row, col);
+
+    dist[k] = max_float;
+    sqdist[k] = INT_MAX;
+    nearest_obstacle[k] = UINT_MAX;
+    flags[k] = VoroFlag | CorridorFlag;
+
+    // propagate the new source to the kept cells
+    GridCellIndex index(row, col);
+    SetVoro(index);
+
+}
+
+// shift the window by a given number of rows and columns
+void GVDLau::ShiftWindow(int drow, int dcol) {
+
+    if ((0 == drow && 0 == dcol) || std::abs(drow) >= (int) height || std::abs(dcol) >= (int) width) {
+
+        if (0 != drow || 0 != dcol) {
+
+            // there's nothing to keep
+            RestartVoronoiDiagram();
+
+        }
+
+        return;
+
+    }
+
+    // the strips
+    unsigned int rl_begin, rl_end, re_begin, re_end, cl_begin, cl_end, ce_begin, ce_end;
+
+    // get the rows and columns leaving and entering the window
+    GetWindowStrips(drow, height, rl_begin, rl_end, re_begin, re_end);
+    GetWindowStrips(dcol, width, cl_begin, cl_end, ce_begin, ce_end);
+
+    // remove the obstacles leaving the window, the cells pointing to them are raised in the old coordinates
+    for (unsigned int r = 0; r < height; ++r) {
+
+        // is it a leaving row? so all the columns are leaving
+        bool leaving_row = rl_begin <= r && r < rl_end;
+
+        // the columns to visit
+        unsigned int c_begin = leaving_row ? 0 : cl_begin;
+        unsigned int c_end = leaving_row ? width : cl_end;
+
+        for (unsigned int c = c_begin; c < c_end; ++c) {
+
+            if (isOccupied(GVD_INDEX(r, c))) {
+
+                RemoveObstacle(r, c);
+
+            }
+
+        }
+
+    }
+
+    // update the cells affected by the removed obstacles, it's proportional to the affected area only
+    UpdateDistanceMap();
+
+    // the voronoi edges leaving the window are removed as well
+    for (unsigned int r = 0; r < height; ++r) {
+
+        // is it a leaving row? so all the columns are leaving
+        bool leaving_row = rl_begin <= r && r < rl_end;
+
+        // the columns to visit
+        unsigned int c_begin = leaving_row ? 0 : cl_begin;
+        unsigned int c_end = leaving_row ? width : cl_end;
+
+        for (unsigned int c = c_begin; c < c_end; ++c) {
+
+            // get the physical index
+            unsigned int k = GVD_INDEX(r, c);
+
+            if (flags[k] & VoroFlag) {
+
+                GridCellIndex index(r, c);
+
+                flags[k] &= ~VoroFlag;
+                UnsetVoro(index);
+
+            }
+
+        }
+
+    }
+
+    // the kept cells pointing to the removed voronoi edges are updated in the old coordinates
+    UpdateVoronoiMap();
+
+    // rotate the window, the leaving cells are reused by the entering ones
+    // the offset and the shift are both below the window size, but their sum may be past twice the size
+    row_offset = (row_offset + height + drow) % height;
+    col_offset = (col_offset + width + dcol) % width;
+
+    // reset the entering cells
+    for (unsigned int r = 0; r < height; ++r) {
+
+        // is it an entering row? so all the columns are entering
+        bool entering_row = re_begin <= r && r < re_end;
+
+        // the columns to visit
+        unsigned int c_begin = entering_row ? 0 : ce_begin;
+        unsigned int c_end = entering_row ? width : ce_end;
+
+        for (unsigned int c = c_begin; c < c_end; ++c) {
+
+            ResetCell(r, c);
+
         }
 
     }
 
+    // the kept cells next to the entering strips are the propagation seeds
+    // the new obstacles are fed later, as any other map change
+    // the distance propagation never reaches the first row and column, so after a backward shift the old first row
+    // or column is kept without distances: the seeds are the old border, for its obstacles, and the next row or column
+    if (0 != drow) {
+
+        // the kept rows next to the entering rows
+        unsigned int r_begin = 0 < drow ? re_begin - 1 : re_end;
+        unsigned int r_end = 0 < drow ? re_begin : std::min(re_end + 2, height);
+
+        for (unsigned int r = r_begin; r < r_end; ++r) {
+
+            for (unsigned int c = 0; c < width; ++c) {
+
+                if (c < ce_begin || ce_end <= c) {
+
+                    SeedCell(r, c);
+
+                }
+
+            }
+
+        }
+
+    }
+
+    if (0 != dcol) {
+
+        // the kept columns next to the entering columns
+        unsigned int c_begin = 0 < dcol ? ce_begin - 1 : ce_end;
+        unsigned int c_end = 0 < dcol ? ce_begin : std::min(ce_end + 2, width);
+
+        for (unsigned int c = c_begin; c < c_end; ++c) {
+
+            for (unsigned int r = 0; r < height; ++r) {
+
+                if (r < re_begin || re_end <= r) {
+
+                    SeedCell(r, c);
+
+                }
+
+            }
+
+        }
+
+    }
+
+}
+
+// push a kept cell to the open queue, so its nearest obstacle is propagated again
+void GVDLau::SeedCell(unsigned int row, unsigned int col) {
+
+    // get the physical index
+    unsigned int k = GVD_INDEX(row, col);
+
+    if (UINT_MAX != nearest_obstacle[k] && !(flags[k] & ToProcessFlag)) {
+
+        // lower the seed again
+        flags[k] |= ToProcessFlag;
+
+        // add to the open queue
+        open.Push(sqdist[k], GridCellIndex(row, col));
+
+    }
+
 }
 
 // set a given cell as an obstacle
 void GVDLau::SetSimpleObstacle(unsigned int row, unsigned int col) {
 
-    // get the current DataCell
-    GVDLau::DataCellRef c(next_data[row][col]);
+    // get the current flat index
+    unsigned int k = GVD_INDEX(row, col);
 
     // update the current cell values
-    c.dist = 0.0;
-    c.sqdist = 0;
-    c.nearest_obstacle.row = row;
-    c.nearest_obstacle.col = col;
-    c.nearest_voro.row = UINT_MAX;
-    c.nearest_voro.col = UINT_MAX;
-    c.to_process = false;
-    c.voro = false;
-    c.is_corridor = false;
+    dist[k] = 0.0f;
+    sqdist[k] = 0;
+    nearest_obstacle[k] = k;
+    nearest_voro[k] = UINT_MAX;
+    flags[k] &= ~(ToProcessFlag | VoroFlag | CorridorFlag);
 
 }
 
 // set a given cell as an obstacle
 void GVDLau::SetSimpleFreeSpace(unsigned int row, unsigned int col) {
 
-    // get the current DataCell
-    GVDLau::DataCellRef c(next_data[row][col]);
+    // get the current flat index
+    unsigned int k = GVD_INDEX(row, col);
 
     // update the current cell values
-    c.sqdist = INT_MAX;
-    c.dist = max_double;
-    c.nearest_obstacle.row = c.nearest_obstacle.col = UINT_MAX;
-    c.to_raise = c.to_process = false;
-    c.is_corridor = true;
+    sqdist[k] = INT_MAX;
+    dist[k] = max_float;
+    nearest_obstacle[k] = UINT_MAX;
+    flags[k] &= ~(ToRaiseFlag | ToProcessFlag);
+    flags[k] |= CorridorFlag;
 
 }
 
 // set a given cell as an obstacle
 void GVDLau::SetObstacle(unsigned int row, unsigned int col) {
 
-    // get the current DataCell
-    GVDLau::DataCellRef c(next_data[row][col]);
+    // get the current flat index
+    unsigned int k = GVD_INDEX(row, col);
 
-    if (c.nearest_obstacle.row == row && c.nearest_obstacle.col == col && c.to_process) {
+    if (k == nearest_obstacle[k] && (flags[k] & ToProcessFlag)) {
         return;
     }
 
     // update the current cell values
-    c.dist = 0.0;
-    c.sqdist = 0;
-    c.nearest_obstacle.row = row;
-    c.nearest_obstacle.col = col;
-    c.to_raise = false;
-    c.to_process = true;
-    c.is_corridor = true;
+    dist[k] = 0.0f;
+    sqdist[k] = 0;
+    nearest_obstacle[k] = k;
+    flags[k] &= ~ToRaiseFlag;
+    flags[k] |= ToProcessFlag | CorridorFlag;
 
     // add to the open prio queue
     open.Push(0, GridCellIndex (row, col));
@@ -741,20 +944,19 @@ void GVDLau::SetObstacle(unsigned int row, unsigned int col) {
 // set a given cell as a free space
 void GVDLau::RemoveObstacle(unsigned int row, unsigned int col) {
 
-    // get the current DataCell
-    GVDLau::DataCellRef c(next_data[row][col]);
+    // get the current flat index
+    unsigned int k = GVD_INDEX(row, col);
 
-    if (UINT_MAX == c.nearest_obstacle.row || UINT_MAX == c.nearest_obstacle.col) {
+    // it must be an obstacle cell, a free cell would be raised as if an obstacle was removed
+    if (!isOccupied(k)) {
         return;
     }
 
     // update the current cell values
-    c.dist = max_double;
-    c.sqdist = INT_MAX;
-    c.nearest_obstacle.row = c.nearest_obstacle.col = UINT_MAX;
-    c.to_raise = true;
-    c.to_process = true;
-    c.is_corridor = true;
+    dist[k] = max_float;
+    sqdist[k] = INT_MAX;
+    nearest_obstacle[k] = UINT_MAX;
+    flags[k] |= ToRaiseFlag | ToProcessFlag | CorridorFlag;
 
     // add to the open prio queue
     open.Push(INT_MAX, GridCellIndex (row, col));
@@ -764,48 +966,17 @@ void GVDLau::RemoveObstacle(unsigned int row, unsigned int col) {
 // update the entire GVD
 bool GVDLau::Update() {
 
-    if (!open.Empty()) {
+    if (!open.Empty() || !voro_open.Empty()) {
 
         // the main distance map
         UpdateDistanceMap();
 
-        // slow voronoi map, let's use the KDTree instead
-        // UpdateVoronoiMap();
+        // the voronoi distance map, from the voronoi edges changed by the distance map update
+        UpdateVoronoiMap();
 
         // save the current map to the external file
         // Visualize("voronoi_map.pgm");
 
-        // clear the old add list vector
-        add_list.clear();
-
-        // update the kdtree
-        for (unsigned int row = 0; row < height; ++row) {
-            for (unsigned int col = 0; col < width; ++col) {
-
-                // get the current data
-                if (next_data[row][col].voro) {
-
-                    // build the point
-                    PointT<unsigned int, 2> point({row, col});
-
-                    // add to the kdtree
-                    //edges.Insert(point);
-                    add_list.push_back(point);
-                }
-            }
-        }
-
-        // rebuild the entire kdtre
-        edges.RebuildKDTree(add_list);
-
-        // update the entire path cost map
-        UpdatePathCostMap();
-
-        // swap the pointers
-        DataCell **tmp = next_data;
-        next_data = data;
-        data = tmp;
-
         // the current map has changed
         return true;
 
@@ -815,48 +986,52 @@ bool GVDLau::Update() {
 
 }
 
+// verify if a given cell is an obstacle cell
+bool GVDLau::isObstacle(unsigned int row, unsigned int col) const {
+
+    return isOccupied(GVD_INDEX(row, col));
+
+}
+
 // get the nearest obstacle distance
-double GVDLau::GetObstacleDistance(unsigned int row, unsigned int col) {
+double GVDLau::GetObstacleDistance(unsigned int row, unsigned int col) const {
 
-    return data[row][col].dist;
+    return dist[GVD_INDEX(row, col)];
 
 }
 
 // get the nearest obstacle index
 GridCellIndex GVDLau::GetObstacleIndex(unsigned int row, unsigned int col) {
 
-    return data[row][col].nearest_obstacle;
+    return FlatToIndex(nearest_obstacle[GVD_INDEX(row, col)]);
 
 }
 
 // get the nearest voronoi edge distance
 double GVDLau::GetVoronoiDistance(unsigned int row, unsigned int col) {
 
-    return data[row][col].voro_dist;
+    return voro_dist[GVD_INDEX(row, col)];
 
 }
 
 // get the nearest voronoi edge distance given the robot's pose
 GridCellIndex GVDLau::GetVoronoiIndex(unsigned int row, unsigned int col) {
 
-    return data[row][col].nearest_voro;
+    return FlatToIndex(nearest_voro[GVD_INDEX(row, col)]);
 
-    /*
-    // build the point
-    PointT<unsigned int, 2u> point({row, col});
+}
 
-    // find the point
-    PointT<unsigned int, 2> found(edges.Nearest(point));
+// verify if a given cell is a voronoi edge
+bool GVDLau::isVoronoiEdge(unsigned int row, unsigned int col) const {
 
-    return GridCellIndex(found[0], found[1]);
-    */
+    return flags[GVD_INDEX(row, col)] & VoroFlag;
 
 }
 
 // get the path cost index
 double GVDLau::GetPathCost(unsigned int row, unsigned int col) {
 
-    return data[row][col].path_cost;
+    return PathCost(GVD_INDEX(row, col));
 
 }
 
@@ -880,19 +1055,19 @@ void GVDLau::Visualize(std::string filename) {
 
                 unsigned char ch = 0;
 
-                // get the actual cell
-                GVDLau::DataCellRef s(data[r][c]);
+                // get the actual flat index
+                unsigned int k = GVD_INDEX(r, c);
 
-                if (s.voro) {
+                if (flags[k] & VoroFlag) {
                     fputc( 0, F );
                     fputc( 0, F );
                     fputc( 255, F );
-                } else if (0 == s.sqdist) {
+                } else if (0 == sqdist[k]) {
                     fputc( 0, F );
                     fputc( 0, F );
                     fputc( 0, F );
                 } else {
-                    float f = 80 + (sqrt(s.sqdist)*10);
+                    float f = 80 + (sqrt(sqdist[k])*10);
                     if (f > 255) f=255;
                     if (f < 0) f = 0;
                     ch = (unsigned char)f;
@@ -920,7 +1095,7 @@ unsigned char* GVDLau::GetPathCostMap() {
 
             for (unsigned int j = 0; j < height; ++j) {
 
-                double v = 1.0 - data[i][j].path_cost;
+                double v = 1.0 - PathCost(GVD_INDEX(i, j));
 
                 if (0.0 > v) {
 
@@ -964,17 +1139,20 @@ unsigned char* GVDLau::GetObstacleDistanceMap() {
 
             for (unsigned int col = 0; col < width; ++col) {
 
-                if (data[row][col].voro) {
+                // get the actual flat index
+                unsigned int n = GVD_INDEX(row, col);
+
+                if (flags[n] & VoroFlag) {
 
                     map[k] = (unsigned char) 255;
 
-                } else if (data[row][col].sqdist <= 0) {
+                } else if (sqdist[n] <= 0) {
 
                     map[k] = 0;
 
                 } else {
 
-                    float f = 80 + (sqrt(data[row][col].sqdist)*10);
+                    float f = 80 + (sqrt(sqdist[n])*10);
                     if (f > 255) f = 255;
                     if (f < 0) f = 0;
                     map[k] = (unsigned char) f;
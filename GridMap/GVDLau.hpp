@@ -30,8 +30,8 @@
 #include <array>
 
 #include "BucketedQueue.hpp"
+#include "AlignedBuffer.hpp"
 #include "../Entities/Pose2D.hpp"
-#include "../KDTree/KDTree.hpp"
 
 #include "GridMapCell.hpp"
 
@@ -43,35 +43,35 @@ namespace astar {
 
         private:
 
-            struct DataCell {
-
-                // the obstacle distance map variables
-                int sqdist;
-                double dist;
-                astar::GridCellIndex nearest_obstacle;
-                bool to_raise;
-                bool to_process;
-                bool voro;
+            // the cell flags, all of them packed in a single byte per cell
+            enum DataCellFlag {
+                ToRaiseFlag = 1 << 0,
+                ToProcessFlag = 1 << 1,
+                VoroFlag = 1 << 2,
+                VoroToRaiseFlag = 1 << 3,
+                VoroToProcessFlag = 1 << 4,
+                CorridorFlag = 1 << 5
+            };
 
-                // the voronoi distance map variables
-                int voro_sqdist;
-                double voro_dist;
-                astar::GridCellIndex nearest_voro;
-                bool voro_to_raise;
-                bool voro_to_process;
+            // the diagram, one row-stride plane for each cell attribute
+            // the obstacle distance planes are the hot ones, the collision checking touches only the dist plane
 
-                double path_cost;
+            // the obstacle distance map variables
+            astar::AlignedBuffer<float> dist;
+            astar::AlignedBuffer<int> sqdist;
 
-                // the corridor flag
-                bool is_corridor;
+            // the nearest obstacle flat index, UINT_MAX means no obstacle
+            astar::AlignedBuffer<unsigned int> nearest_obstacle;
 
-            };
+            // the packed flags
+            astar::AlignedBuffer<unsigned char> flags;
 
-            typedef DataCell* DataCellPtr;
-            typedef DataCell& DataCellRef;
+            // the voronoi distance map variables
+            astar::AlignedBuffer<float> voro_dist;
+            astar::AlignedBuffer<int> voro_sqdist;
 
-            // the diagram
-            DataCell **data, **next_data;
+            // the nearest voronoi edge flat index, UINT_MAX means no voronoi edge
+            astar::AlignedBuffer<unsigned int> nearest_voro;
 
             // the diagram parameters
             unsigned int height;
@@ -79,12 +79,15 @@ namespace astar {
             unsigned int width;
             int widthminus1;
 
+            // the toroidal window offsets, the logical cell (0, 0) is stored at the physical cell (row_offset, col_offset)
+            unsigned int row_offset, col_offset;
+
             // the general parameters
             double alpha;
             double max_dist, max_sqdist;
 
-            // double max value
-            double max_double;
+            // the unknown distance value
+            float max_float;
 
             // is it allocated?
             bool initialized;
@@ -93,20 +96,20 @@ namespace astar {
             astar::BucketPrioQueue<astar::GridCellIndex> open;
             astar::BucketPrioQueue<astar::GridCellIndex> voro_open;
 
-            // the voro edges kdtre
-            astar::KDTree<unsigned int, 2> edges;
-
-            // the voro add list
-            std::vector<astar::PointT<unsigned int, 2>> add_list;
-
             // PRIVATE METHODS
 
             // remove the entire allocated diagram
             void RemoveDiagram();
 
+            // allocate all the planes with the current dimensions
+            void AllocateDiagram();
+
             // verify a given index against the map dimensions
             bool isValidIndex(const astar::GridCellIndexRef) const;
 
+            // get the row and column of a given flat index
+            astar::GridCellIndex FlatToIndex(unsigned int) const;
+
             // get the squared distance between two cells
             int DistanceSquared(const astar::GridCellIndexRef, const astar::GridCellIndexRef);
 
@@ -114,14 +117,15 @@ namespace astar {
             inline bool isOccupied(const astar::GridCellIndexRef) const;
 
             // verify if a given cell is occupied, wich means that the nearest obstacle is the given cell
-            // overloaded version
-            inline bool isOccupied(const astar::GridCellIndexRef, const DataCellRef);
+            // flat index overloaded version
+            inline bool isOccupied(unsigned int) const;
 
             // verify if a given is voro occupied, wich means that the nearest voro is the give cell
             bool isVoroOccupied(const astar::GridCellIndexRef);
 
             // verify if a given is voro occupied, wich means that the nearest voro is the give cell
-            bool isVoroOccupied(const astar::GridCellIndexRef, const DataCellRef);
+            // flat index overloaded version
+            bool isVoroOccupied(unsigned int);
 
             // set a given cell as voro
             void SetVoro(const astar::GridCellIndexRef);
@@ -138,8 +142,17 @@ namespace astar {
             // update the voronoi distance map
             void UpdateVoronoiMap();
 
-            // update the path cost map
-            void UpdatePathCostMap();
+            // get the path cost of a given cell, computed from the distance fields
+            double PathCost(unsigned int) const;
+
+            // get the rows or columns leaving the window, in the old coordinates, and the ones entering it, in the new coordinates
+            void GetWindowStrips(int shift, unsigned int n, unsigned int &leaving_begin, unsigned int &leaving_end, unsigned int &entering_begin, unsigned int &entering_end) const;
+
+            // reset a given cell to the restart values, the cell is a new voro source
+            void ResetCell(unsigned int row, unsigned int col);
+
+            // push a kept cell to the open queue, so its nearest obstacle is propagated again
+            void SeedCell(unsigned int row, unsigned int col);
 
         public:
 
@@ -170,11 +183,20 @@ namespace astar {
             // set a given cell as a free space
             void RemoveObstacle(unsigned int row, unsigned int col);
 
+            // shift the window by a given number of rows and columns, the new cell (r, c) is the old cell (r + drow, c + dcol)
+            // the kept cells are not moved in memory: the obstacles leaving the window are removed,
+            // the entering cells are reset and the kept border cells are pushed to the open queue
+            // the entering obstacles must be set as usual and the next Update call propagates them
+            void ShiftWindow(int drow, int dcol);
+
             // update the entire GVD
             bool Update();
 
+            // verify if a given cell is an obstacle cell
+            bool isObstacle(unsigned int row, unsigned int col) const;
+
             // get the nearest obstacle distance
-            double GetObstacleDistance(unsigned int row, unsigned int col);
+            double GetObstacleDistance(unsigned int row, unsigned int col) const;
 
             // get the nearest obstacle index
             GridCellIndex GetObstacleIndex(unsigned int row, unsigned int col);
@@ -182,10 +204,12 @@ namespace astar {
             // get the nearest voronoi edge distance
             double GetVoronoiDistance(unsigned int row, unsigned int col);
 
-            // get the nearest voronoi edge distance given a valid
-            // unsigned int overloaded, KDTree usage
+            // get the nearest voronoi edge index
             GridCellIndex GetVoronoiIndex(unsigned int row, unsigned int col);
 
+            // verify if a given cell is a voronoi edge
+            bool isVoronoiEdge(unsigned int row, unsigned int col) const;
+
             // get the path cost index
             double GetPathCost(unsigned int row, unsigned int col);
 
@@ -3,7 +3,12 @@
 #include <string>
 #include <ctime>
 #include <cmath>
+#include <climits>
+#include <chrono>
+#include <vector>
+#include <algorithm>
 #include "../Entities/Pose2D.cpp"
+#include "../KDTree/KDTree.hpp"
 #include "GVDLau.hpp"
 
 // load the PGM file
@@ -55,6 +60,290 @@ void loadPGM(std::istream &is, int *sizeX, int *sizeY, bool ***map)
 	}
 }
 
+// the elapsed time in milliseconds
+double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the old voronoi distance field: a KDTree with all the voronoi edges and a nearest query for each cell
+double KDTreeVoronoiSweep(astar::GVDLau &gvd, int width, int height, std::vector<double> &voro_dist)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// get the voronoi edges
+	std::vector<astar::PointT<unsigned int, 2>> edges;
+	for (unsigned int r = 0; r < (unsigned int) height; ++r)
+	{
+		for (unsigned int c = 0; c < (unsigned int) width; ++c)
+		{
+			if (gvd.isVoronoiEdge(r, c))
+			{
+				edges.push_back({r, c});
+			}
+		}
+	}
+
+	// rebuild the kdtree
+	astar::KDTree<unsigned int, 2> kdtree(INT_MAX);
+	kdtree.RebuildKDTree(edges);
+
+	// the nearest edge of each cell
+	voro_dist.resize(width * height);
+	for (unsigned int r = 0, k = 0; r < (unsigned int) height; ++r)
+	{
+		for (unsigned int c = 0; c < (unsigned int) width; ++c, ++k)
+		{
+			astar::PointT<unsigned int, 2> found(kdtree.Nearest({r, c}));
+
+			int dr = (int) found[0] - (int) r;
+			int dc = (int) found[1] - (int) c;
+
+			voro_dist[k] = std::sqrt(dr*dr + dc*dc);
+		}
+	}
+
+	return ElapsedMilliseconds(start);
+}
+
+// the exact voronoi distance errors of both approaches, over a sample of cells
+void VoronoiFieldErrors(astar::GVDLau &gvd, int width, int height, const std::vector<double> &kd_voro_dist)
+{
+	// get the voronoi edges
+	std::vector<astar::GridCellIndex> edges;
+	for (unsigned int r = 0; r < (unsigned int) height; ++r)
+	{
+		for (unsigned int c = 0; c < (unsigned int) width; ++c)
+		{
+			if (gvd.isVoronoiEdge(r, c))
+			{
+				edges.push_back(astar::GridCellIndex(r, c));
+			}
+		}
+	}
+
+	unsigned int samples = 0, kd_wrong = 0, brushfire_wrong = 0;
+	double kd_max = 0.0, brushfire_max = 0.0;
+
+	for (unsigned int r = 0; r < (unsigned int) height; r += 7)
+	{
+		for (unsigned int c = 0; c < (unsigned int) width; c += 7)
+		{
+			// brute force
+			int best = INT_MAX;
+			for (unsigned int i = 0; i < edges.size(); ++i)
+			{
+				int dr = (int) edges[i].row - (int) r;
+				int dc = (int) edges[i].col - (int) c;
+				best = std::min(best, dr*dr + dc*dc);
+			}
+
+			double exact = std::sqrt(best);
+			double kd_error = std::fabs(kd_voro_dist[r * width + c] - exact);
+			double brushfire_error = std::fabs(gvd.GetVoronoiDistance(r, c) - exact);
+
+			if (1e-3 < kd_error) { kd_wrong += 1; kd_max = std::max(kd_max, kd_error); }
+			if (1e-3 < brushfire_error) { brushfire_wrong += 1; brushfire_max = std::max(brushfire_max, brushfire_error); }
+
+			samples += 1;
+		}
+	}
+
+	std::cout << "    exact distance check over " << samples << " cells: kdtree wrong " << kd_wrong << " (max error " << kd_max
+			  << "), brushfire wrong " << brushfire_wrong << " (max error " << brushfire_max << ")\n";
+}
+
+// compare the incremental brushfire voronoi distance field against the old kdtree sweep
+void VoronoiFieldBenchmark(bool **map, int width, int height)
+{
+	std::cout << "\nVoronoi distance field benchmark, brushfire vs kdtree sweep, " << width << "x" << height << " map\n";
+
+	astar::GVDLau gvd;
+	gvd.InitializeEmpty(height, width);
+
+	// the full build
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int r = 0; r < height; ++r)
+	{
+		for (int c = 0; c < width; ++c)
+		{
+			if (map[r][c])
+			{
+				gvd.SetObstacle(r, c);
+			}
+		}
+	}
+	gvd.Update();
+	double build = ElapsedMilliseconds(start);
+
+	std::vector<double> kd_voro_dist;
+	double sweep = KDTreeVoronoiSweep(gvd, width, height, kd_voro_dist);
+
+	std::cout << "  full build: GVD with brushfire " << build << " ms, kdtree sweep alone " << sweep << " ms\n";
+	VoronoiFieldErrors(gvd, width, height, kd_voro_dist);
+
+	// the incremental frames, a moving block of toggled cells
+	const int frames = 20;
+	const int block_rows = std::min(20, height / 4), block_cols = std::min(40, width / 4);
+	double brushfire_total = 0.0, sweep_total = 0.0;
+	unsigned int changed = 0;
+
+	for (int f = 0; f < frames; ++f)
+	{
+		int r0 = (f * 37) % (height - block_rows);
+		int c0 = (f * 53) % (width - block_cols);
+
+		start = std::chrono::steady_clock::now();
+		for (int r = r0; r < r0 + block_rows; ++r)
+		{
+			for (int c = c0; c < c0 + block_cols; ++c)
+			{
+				map[r][c] = !map[r][c];
+
+				if (map[r][c])
+				{
+					gvd.SetObstacle(r, c);
+				}
+				else
+				{
+					gvd.RemoveObstacle(r, c);
+				}
+
+				changed += 1;
+			}
+		}
+		gvd.Update();
+		brushfire_total += ElapsedMilliseconds(start);
+
+		// the old approach runs over the entire map after each frame
+		sweep_total += KDTreeVoronoiSweep(gvd, width, height, kd_voro_dist);
+	}
+
+	std::cout << "  " << frames << " incremental frames, " << changed / frames << " changed cells each: GVD with brushfire "
+			  << brushfire_total / frames << " ms/frame, kdtree sweep alone " << sweep_total / frames << " ms/frame\n";
+	VoronoiFieldErrors(gvd, width, height, kd_voro_dist);
+
+	// restore the map
+	for (int f = 0; f < frames; ++f)
+	{
+		int r0 = (f * 37) % (height - block_rows);
+		int c0 = (f * 53) % (width - block_cols);
+
+		for (int r = r0; r < r0 + block_rows; ++r)
+		{
+			for (int c = c0; c < c0 + block_cols; ++c)
+			{
+				map[r][c] = !map[r][c];
+			}
+		}
+	}
+}
+
+// build a GVD over a window of the map, the window starts at the (row, col) map cell
+void BuildWindow(astar::GVDLau &gvd, bool **map, int row, int col, int height, int width)
+{
+	gvd.InitializeEmpty(height, width);
+
+	for (int r = 0; r < height; ++r)
+	{
+		for (int c = 0; c < width; ++c)
+		{
+			if (map[row + r][col + c])
+			{
+				gvd.SetObstacle(r, c);
+			}
+		}
+	}
+
+	gvd.Update();
+}
+
+// shift a window over the map and compare the obstacle distances to a full rebuild of the same window
+// the first row and column are not updated by the distance propagation, so they are not compared
+// returns how many cells are wrong
+unsigned int ShiftWindowCheck(bool **map, int width, int height)
+{
+	const int window_height = std::min(120, height / 2), window_width = std::min(160, width / 2);
+
+	// the positive, negative and diagonal shifts, applied in sequence
+	const int shifts[][2] = { {3, 0}, {-3, 0}, {-1, 0}, {0, 1}, {0, -1}, {2, -2}, {-2, 2}, {-4, -5}, {5, 4}, {1, 1}, {-1, -1}, {-30, 17}, {40, -60}, {-7, -90} };
+
+	// the window starts at the map center
+	int row = (height - window_height) / 2, col = (width - window_width) / 2;
+
+	astar::GVDLau gvd, rebuilt;
+	BuildWindow(gvd, map, row, col, window_height, window_width);
+
+	std::cout << "\nShift window check, a " << window_width << "x" << window_height << " window against a full rebuild\n";
+
+	unsigned int failures = 0;
+
+	for (unsigned int i = 0; i < sizeof(shifts) / sizeof(shifts[0]); ++i)
+	{
+		int drow = shifts[i][0], dcol = shifts[i][1];
+
+		gvd.ShiftWindow(drow, dcol);
+
+		row += drow;
+		col += dcol;
+
+		// the entering obstacles, the shifted window keeps all the other cells
+		for (int r = 0; r < window_height; ++r)
+		{
+			for (int c = 0; c < window_width; ++c)
+			{
+				bool entering = (0 < drow ? window_height - drow <= r : r < -drow) || (0 < dcol ? window_width - dcol <= c : c < -dcol);
+
+				if (entering && map[row + r][col + c])
+				{
+					gvd.SetObstacle(r, c);
+				}
+			}
+		}
+
+		gvd.Update();
+
+		BuildWindow(rebuilt, map, row, col, window_height, window_width);
+
+		unsigned int wrong = 0;
+		double worst = 0.0, expected = 0.0, found = 0.0;
+
+		for (int r = 1; r < window_height; ++r)
+		{
+			for (int c = 1; c < window_width; ++c)
+			{
+				double a = gvd.GetObstacleDistance(r, c), b = rebuilt.GetObstacleDistance(r, c);
+				double error = std::fabs(a - b);
+
+				if (1e-3 < error)
+				{
+					wrong += 1;
+
+					if (worst < error)
+					{
+						worst = error;
+						found = a;
+						expected = b;
+					}
+				}
+			}
+		}
+
+		std::cout << "  shift (" << drow << ", " << dcol << "): " << wrong << " cells wrong";
+
+		if (0 < wrong)
+		{
+			std::cout << ", worst " << found << " instead of " << expected;
+		}
+
+		std::cout << "\n";
+
+		failures += wrong;
+	}
+
+	return failures;
+}
+
 int main (int argc, char **argv)
 {
 	if(argc < 2 || argc > 3)
@@ -153,7 +442,7 @@ int main (int argc, char **argv)
 	std::cout << "........................................\n";
 
 	// test the nearest voro edge query
-	std::cout << "\nKDtree based Nearest voronoi edge distance query for (" << r << ", " << c << "), it should not be: inf! ...\n";
+	std::cout << "\nNearest voronoi edge index query for (" << r << ", " << c << "), it should not be: inf! ...\n";
 	astar::GridCellIndex index_c(gvd.GetVoronoiIndex(r, c));
 	std::cout << "Done! Result voro_dist(" << r << ", " << c << "): (" << index_c.row << ", " << index_c.col << ")" << "\n";
 
@@ -167,6 +456,12 @@ int main (int argc, char **argv)
 	gvd.Visualize(filename);
 	std::cout << "Done\n";
 
+	// the voronoi distance field benchmark
+	VoronoiFieldBenchmark(map, width, height);
+
+	// the shifted windows must match a full rebuild
+	unsigned int shift_failures = ShiftWindowCheck(map, width, height);
+
 	// delete the allocated map
 	if (nullptr != map)
 	{
@@ -179,5 +474,5 @@ int main (int argc, char **argv)
 		// remove the map pointer
 		delete [] map;
 	}
-	return 0;
+	return 0 == shift_failures ? 0 : 1;
 }
@@ -12,8 +12,6 @@ typedef GridMapCell* GridMapCellPtr;
 // define a reference
 typedef GridMapCell& GridMapCellRef;
 
-typedef GridMapCell** GridMap;
-
 }
 
 #endif
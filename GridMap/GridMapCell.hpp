@@ -22,13 +22,9 @@
 #define INTERNAL_GRID_MAP_CELL_HPP
 
 #include "GridMapCell.fwd.hpp"
-#include "../PathFinding/HybridAstar/HybridAstarNode.fwd.hpp"
 
 namespace astar {
 
-    // define the enumeration status
-    enum CellStatus {UnknownNode, OpenedNode, ExploredNode};
-
     class GridMapCell
     {
         public:
@@ -38,24 +34,16 @@ namespace astar {
             // the occupancy
             int occupancy;
 
-            // the cell status
-            CellStatus status;
-
-            // the robot state
-            astar::HybridAstarNodePtr node;
-
             // the corridor flag
             bool is_corridor;
 
             // PUBLIC METHODS
-            GridMapCell() : occupancy(0), status(astar::UnknownNode), node(nullptr), is_corridor(false) {}
+            GridMapCell() : occupancy(0), is_corridor(false) {}
 
             // the overloading operator
             void operator=(const GridMapCell &c)
             {
                 occupancy = c.occupancy;
-                status = c.status;
-                node = nullptr;
                 is_corridor = c.is_corridor;
             }
 
@@ -1,20 +1,30 @@
 #include <iostream>
 #include <cmath>
+#include <chrono>
+#include <limits>
+#include <algorithm>
 
 #include "InternalGridMap.hpp"
 
+// the SSE2 batch collision kernel, x86-64 always has it
+#if defined(__SSE2__) && !defined(HYBRID_ASTAR_SCALAR_COLLISION)
+#define HYBRID_ASTAR_SSE2_COLLISION
+#include <emmintrin.h>
+#endif
+
 using namespace astar;
 
 InternalGridMap::InternalGridMap() :
     width(0), width_2(0),
     height(0), height_2(0),
     size(0),
+    resolution(0.0), inverse_resolution(0.0),
     diagonal_resolution(0),
     origin(),
-    grid_map(nullptr),
     has_changed(false),
     corridor(0),
-    voronoi(), resolution(0.0), inverse_resolution(0.0)
+    voronoi(), changed_cells(), gvd_metrics(),
+    grid_map()
 {}
 
 // basic destructor
@@ -45,27 +55,67 @@ astar::GridCellIndex InternalGridMap::PoseToIndex(const astar::Vector2D<double>
 void InternalGridMap::RemoveGridMap()
 {
     // the GridMapCell map
-    if (nullptr != grid_map)
+    grid_map.Resize(0);
+}
+
+// process the voronoi diagram
+void InternalGridMap::ProcessVoronoiDiagram()
+{
+    has_changed = voronoi.Update();
+}
+
+// feed only the changed cells to the voronoi diagram and process it
+void InternalGridMap::UpdateVoronoiDiagram()
+{
+    // the starting time
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::vector<unsigned int>::iterator it = changed_cells.begin(); it != changed_cells.end(); ++it)
     {
-        for (unsigned int i = 0; i < height; ++i)
+        // get the row and column, row-stride storage
+        unsigned int row = *it / width;
+        unsigned int col = *it % width;
+
+        if (0 < grid_map[*it].occupancy)
         {
-           delete [] grid_map[i];
+            voronoi.SetObstacle(row, col);
+        }
+        else
+        {
+            voronoi.RemoveObstacle(row, col);
         }
-        delete [] grid_map;
     }
+
+    // process the voronoi diagram
+    ProcessVoronoiDiagram();
+
+    // save the metrics
+    gvd_metrics.changed_cells = changed_cells.size();
+    gvd_metrics.total_cells = size;
+    gvd_metrics.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // the changes were consumed
+    changed_cells.clear();
 }
 
-// process the voronoi diagram
-void InternalGridMap::ProcessVoronoiDiagram()
+// get the last voronoi diagram update metrics
+const GVDUpdateMetrics& InternalGridMap::GetGVDMetrics() const
 {
-    has_changed = voronoi.Update();
+    return gvd_metrics;
 }
 
-// get the map parameters and allocate the grid map in the memmory
-void InternalGridMap::UpdateGridMap(unsigned int h, unsigned int w, double res, const astar::Vector2D<double> &_origin, double *map)
+// update the map dimensions and origin, a new window resets or shifts the voronoi diagram
+void InternalGridMap::UpdateGridMapConfig(unsigned int h, unsigned int w, double res, const astar::Vector2D<double> &_origin)
 {
     has_changed = false;
 
+    // the cells are compared against the voronoi diagram state, so any old change not consumed yet is found again
+    changed_cells.clear();
+
+    // the diagram is updated incrementally by default
+    gvd_metrics.full_rebuild = false;
+    gvd_metrics.row_shift = gvd_metrics.col_shift = 0;
+
     if (w != width || h != height || res != resolution)
     {
         has_changed = true;
@@ -84,23 +134,54 @@ void InternalGridMap::UpdateGridMap(unsigned int h, unsigned int w, double res,
         diagonal_resolution = res * std::sqrt(2.0);
         origin = _origin;
 
-        // allocate the row pointers
-        grid_map = new GridMapCellPtr[height];
-        for (unsigned int i = 0; i < height; ++i)
-        {
-            grid_map[i] = new GridMapCell[width];
-        }
+        // allocate the grid map, a single row-stride block
+        grid_map.Resize(size);
 
         // restart the voronoi diagram
         voronoi.InitializeEmpty(height, width);
+
+        // all the diagram cells are free now, so the occupied ones will be seen as changed cells below
+        gvd_metrics.full_rebuild = true;
     }
     else if (origin != _origin)
     {
         has_changed = true;
 
+        // the window displacement, in cells
+        double drow = (_origin.y - origin.y) * inverse_resolution;
+        double dcol = (_origin.x - origin.x) * inverse_resolution;
+
+        // round it
+        gvd_metrics.row_shift = std::floor(drow + 0.5);
+        gvd_metrics.col_shift = std::floor(dcol + 0.5);
+
+        // the cells must be aligned with the old ones and some of them must be kept
+        bool aligned = 1e-3 > std::fabs(drow - gvd_metrics.row_shift) && 1e-3 > std::fabs(dcol - gvd_metrics.col_shift);
+        bool overlap = std::abs(gvd_metrics.row_shift) < (int) height && std::abs(gvd_metrics.col_shift) < (int) width;
+
+        if (aligned && overlap)
+        {
+            // the kept part of the diagram is reused, only the entering strips are new
+            voronoi.ShiftWindow(gvd_metrics.row_shift, gvd_metrics.col_shift);
+        }
+        else
+        {
+            // there's nothing to keep
+            voronoi.RestartVoronoiDiagram();
+
+            gvd_metrics.full_rebuild = true;
+        }
+
         // update the origin
         origin = _origin;
     }
+}
+
+// get the map parameters and allocate the grid map in the memmory
+void InternalGridMap::UpdateGridMap(unsigned int h, unsigned int w, double res, const astar::Vector2D<double> &_origin, double *map)
+{
+    // the dimensions and the window shift
+    UpdateGridMapConfig(h, w, res, _origin);
 
     unsigned int k = 0;
 
@@ -108,20 +189,35 @@ void InternalGridMap::UpdateGridMap(unsigned int h, unsigned int w, double res,
     {
         for (unsigned int row = 0; row < height; ++row)
         {
+            // the current cell index
+            unsigned int index = GRID_MAP_INDEX(row, col);
+
+            // get the current cell
+            GridMapCellRef c(grid_map[index]);
+
+            // the occupied state known by the voronoi diagram, after any window shift
+            bool was_occupied = voronoi.isObstacle(row, col);
+
             if (0.4 < map[k])
             {
-                grid_map[row][col].occupancy = 1.0;
+                c.occupancy = 1.0;
             }
             else if (0 > map[k])
             {
-                grid_map[row][col].occupancy = -1.0;
+                c.occupancy = -1.0;
             }
             else
             {
-                grid_map[row][col].occupancy = 0.0;
+                c.occupancy = 0.0;
             }
 
-            grid_map[row][col].is_corridor = false;
+            c.is_corridor = false;
+
+            // save the changed cell
+            if (was_occupied != (0 < c.occupancy))
+            {
+                changed_cells.push_back(index);
+            }
 
             ++k;
         }
@@ -131,6 +227,44 @@ void InternalGridMap::UpdateGridMap(unsigned int h, unsigned int w, double res,
     // voronoi.RestartVoronoiDiagram();
 }
 
+// get the map parameters and rebuild the grid map from a sparse list of cells, the other cells are free
+void InternalGridMap::UpdateCompactGridMap(unsigned int h, unsigned int w, double res, const astar::Vector2D<double> &_origin,
+        unsigned int n, const int *rows, const int *cols, const double *values)
+{
+    // the dimensions and the window shift
+    UpdateGridMapConfig(h, w, res, _origin);
+
+    // the cells not in the list are free
+    for (unsigned int index = 0; index < size; ++index)
+    {
+        grid_map[index].occupancy = 0.0;
+        grid_map[index].is_corridor = false;
+    }
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (0 <= rows[i] && height > (unsigned int) rows[i] && 0 <= cols[i] && width > (unsigned int) cols[i] && 0.5 < values[i])
+        {
+            grid_map[GRID_MAP_INDEX(rows[i], cols[i])].occupancy = 1.0;
+        }
+    }
+
+    // the voronoi diagram may know obstacles outside the list, so all the cells are compared
+    for (unsigned int row = 0; row < height; ++row)
+    {
+        for (unsigned int col = 0; col < width; ++col)
+        {
+            unsigned int index = GRID_MAP_INDEX(row, col);
+
+            // save the changed cell
+            if (voronoi.isObstacle(row, col) != (0 < grid_map[index].occupancy))
+            {
+                changed_cells.push_back(index);
+            }
+        }
+    }
+}
+
 // expand a circular region around the RDDF point
 void InternalGridMap::ExpandRegion(GridCellIndex &index, unsigned int distance)
 {
@@ -163,12 +297,12 @@ void InternalGridMap::ExpandRegion(GridCellIndex &index, unsigned int distance)
             dcol2 = (unsigned int) (dcol*dcol);
 
             // top
-            if (distance > (drow2 + dcol2) && !grid_map[nrow][col].is_corridor)
+            if (distance > (drow2 + dcol2) && !grid_map[GRID_MAP_INDEX(nrow, col)].is_corridor)
             {
                 tmp.row = nrow;
                 tmp.col = col;
 
-                grid_map[nrow][col].is_corridor = true;
+                grid_map[GRID_MAP_INDEX(nrow, col)].is_corridor = true;
 
                 indexes.push_back(tmp);
 
@@ -187,12 +321,12 @@ void InternalGridMap::ExpandRegion(GridCellIndex &index, unsigned int distance)
             dcol2 = (unsigned int) (dcol*dcol);
 
             // top
-            if (distance > (drow2 + dcol2) && !grid_map[nrow][col].is_corridor)
+            if (distance > (drow2 + dcol2) && !grid_map[GRID_MAP_INDEX(nrow, col)].is_corridor)
             {
                 tmp.row = nrow;
                 tmp.col = col;
 
-                grid_map[nrow][col].is_corridor = true;
+                grid_map[GRID_MAP_INDEX(nrow, col)].is_corridor = true;
 
                 indexes.push_back(tmp);
 
@@ -210,12 +344,12 @@ void InternalGridMap::ExpandRegion(GridCellIndex &index, unsigned int distance)
             dcol = ((int) ncol) - index_col;
             dcol2 = (unsigned int) (dcol*dcol);
 
-            if (distance > (drow2 + dcol2) && !grid_map[row][ncol].is_corridor)
+            if (distance > (drow2 + dcol2) && !grid_map[GRID_MAP_INDEX(row, ncol)].is_corridor)
             {
                 tmp.row = row;
                 tmp.col = ncol;
 
-                grid_map[row][ncol].is_corridor = true;
+                grid_map[GRID_MAP_INDEX(row, ncol)].is_corridor = true;
 
                 indexes.push_back(tmp);
 
@@ -233,12 +367,12 @@ void InternalGridMap::ExpandRegion(GridCellIndex &index, unsigned int distance)
             dcol = ((int) ncol) - index_col;
             dcol2 = (unsigned int) (dcol*dcol);
 
-            if (distance > (drow2 + dcol2)  && !grid_map[row][ncol].is_corridor)
+            if (distance > (drow2 + dcol2)  && !grid_map[GRID_MAP_INDEX(row, ncol)].is_corridor)
             {
                 tmp.row = row;
                 tmp.col = ncol;
 
-                grid_map[row][ncol].is_corridor = true;
+                grid_map[GRID_MAP_INDEX(row, ncol)].is_corridor = true;
 
                 indexes.push_back(tmp);
 
@@ -332,6 +466,177 @@ bool InternalGridMap::isSafePlace(const std::vector<astar::Circle> &body, double
     return true;
 }
 
+// verify if the vehicle footprint at a given position and orientation is safe
+bool InternalGridMap::isSafePlace(const astar::Vector2D<double> &position, double orientation, const astar::VehicleFootprint &footprint, double safety_factor, double margin) const
+{
+    // the minimum obstacle distance in cells, the heading table error and the given margin included
+    double min_distance = (footprint.radius * safety_factor + footprint.heading_error + margin) * inverse_resolution;
+
+    // the rotated circle offsets from the heading table
+    const double *xy = footprint.GetRotatedOffsets(orientation);
+
+    // the rear axle position in cells, the rounding offset included
+    double x = (position.x - origin.x) * inverse_resolution + 0.5;
+    double y = (position.y - origin.y) * inverse_resolution + 0.5;
+
+    for (unsigned int i = 0; i < footprint.size; ++i)
+    {
+        // the current circle cell
+        double col = std::floor(x + xy[2 * i] * inverse_resolution);
+        double row = std::floor(y + xy[2 * i + 1] * inverse_resolution);
+
+        // outside the grid map
+        if (0.0 > row || 0.0 > col || height <= row || width <= col)
+        {
+            return false;
+        }
+
+        // get the closest obstacle from the voronoi distance map
+        if (voronoi.GetObstacleDistance(row, col) < min_distance)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// verify if the vehicle footprint at a given pose is safe
+bool InternalGridMap::isSafePlace(const astar::Pose2D &pose, const astar::VehicleFootprint &footprint, double safety_factor) const
+{
+    return isSafePlace(pose.position, pose.orientation, footprint, safety_factor);
+}
+
+// get the smallest distance between the footprint circles and the unsafe region around the obstacles
+double InternalGridMap::GetClearance(const astar::Vector2D<double> &position, double orientation, const astar::VehicleFootprint &footprint, double safety_factor, double margin) const
+{
+    // the minimum obstacle distance in cells, the heading table error and the given margin included
+    double min_distance = (footprint.radius * safety_factor + footprint.heading_error + margin) * inverse_resolution;
+
+    // the rotated circle offsets from the heading table
+    const double *xy = footprint.GetRotatedOffsets(orientation);
+
+    // the rear axle position in cells, the rounding offset included
+    double x = (position.x - origin.x) * inverse_resolution + 0.5;
+    double y = (position.y - origin.y) * inverse_resolution + 0.5;
+
+    // the smallest clearance in cells
+    double clearance = std::numeric_limits<double>::max();
+
+    for (unsigned int i = 0; i < footprint.size; ++i)
+    {
+        // the current circle cell
+        double col = std::floor(x + xy[2 * i] * inverse_resolution);
+        double row = std::floor(y + xy[2 * i + 1] * inverse_resolution);
+
+        // outside the grid map
+        if (0.0 > row || 0.0 > col || height <= row || width <= col)
+        {
+            return -1.0;
+        }
+
+        // the closest obstacle from the voronoi distance map
+        clearance = std::min(clearance, voronoi.GetObstacleDistance(row, col) - min_distance);
+
+        // the unsafe circle
+        if (0.0 > clearance)
+        {
+            break;
+        }
+    }
+
+    return clearance * resolution;
+}
+
+// verify a batch of poses at once, returns a mask with the bit i set if the pose i is safe
+unsigned int InternalGridMap::CheckPoses(const astar::Pose2D *poses, unsigned int n, const astar::VehicleFootprint &footprint, double safety_factor) const
+{
+    // the output mask
+    unsigned int mask = 0;
+
+#ifdef HYBRID_ASTAR_SSE2_COLLISION
+
+    // the minimum obstacle distance in cells, the heading table error included
+    const __m128 min_distance = _mm_set1_ps((footprint.radius * safety_factor + footprint.heading_error) * inverse_resolution);
+
+    // the grid map limits in cells
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 w = _mm_set1_ps(width);
+    const __m128 h = _mm_set1_ps(height);
+
+    // the cell size
+    const __m128 inv = _mm_set1_ps(inverse_resolution);
+
+    // the truncated cells
+    alignas(16) int rows[4], cols[4];
+
+    for (unsigned int p = 0; p < n && p < 32; ++p)
+    {
+        // the rear axle position in cells, the rounding offset included
+        // the subtraction is made in double precision, the world coordinates are large
+        const __m128 x = _mm_set1_ps((poses[p].position.x - origin.x) * inverse_resolution + 0.5);
+        const __m128 y = _mm_set1_ps((poses[p].position.y - origin.y) * inverse_resolution + 0.5);
+
+        // the rotated circle offsets from the heading table
+        const float *lanes = footprint.GetRotatedLanes(poses[p].orientation);
+
+        bool safe = true;
+
+        // four circles at once
+        for (unsigned int i = 0; safe && i < footprint.size; i += 4)
+        {
+            // the circle centers
+            __m128 cx = _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(lanes + i), inv));
+            __m128 cy = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(lanes + astar::VehicleFootprint::MaxCircles + i), inv));
+
+            // all the centers must be inside the grid map
+            __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(cx, zero), _mm_cmplt_ps(cx, w)),
+                _mm_and_ps(_mm_cmpge_ps(cy, zero), _mm_cmplt_ps(cy, h)));
+
+            if (0xf != _mm_movemask_ps(inside))
+            {
+                safe = false;
+                break;
+            }
+
+            // the truncation is the floor, the centers are non negative
+            _mm_store_si128(reinterpret_cast<__m128i*>(cols), _mm_cvttps_epi32(cx));
+            _mm_store_si128(reinterpret_cast<__m128i*>(rows), _mm_cvttps_epi32(cy));
+
+            // gather the obstacle distances
+            __m128 d = _mm_set_ps(
+                voronoi.GetObstacleDistance(rows[3], cols[3]),
+                voronoi.GetObstacleDistance(rows[2], cols[2]),
+                voronoi.GetObstacleDistance(rows[1], cols[1]),
+                voronoi.GetObstacleDistance(rows[0], cols[0]));
+
+            // any circle too close to an obstacle
+            safe = 0 == _mm_movemask_ps(_mm_cmplt_ps(d, min_distance));
+        }
+
+        if (safe)
+        {
+            mask |= 1u << p;
+        }
+    }
+
+#else
+
+    // the scalar fallback
+    for (unsigned int p = 0; p < n && p < 32; ++p)
+    {
+        if (isSafePlace(poses[p], footprint, safety_factor))
+        {
+            mask |= 1u << p;
+        }
+    }
+
+#endif
+
+    return mask;
+}
+
 // return a cell given a pose
 GridMapCellPtr InternalGridMap::PoseToCell(const astar::Pose2D &p)
 {
@@ -339,7 +644,7 @@ GridMapCellPtr InternalGridMap::PoseToCell(const astar::Pose2D &p)
     GridCellIndex index(PoseToIndex(p.position));
 
     if (height > index.row && width > index.col)
-        return &grid_map[index.row][index.col];
+        return &grid_map[GRID_MAP_INDEX(index.row, index.col)];
     else
         return nullptr;
 }
@@ -348,7 +653,7 @@ GridMapCellPtr InternalGridMap::PoseToCell(const astar::Pose2D &p)
 GridMapCellPtr InternalGridMap::IndexToCell(const astar::GridCellIndex &index)
 {
     if (height > index.row && width > index.col)
-        return &grid_map[index.row][index.col];
+        return &grid_map[GRID_MAP_INDEX(index.row, index.col)];
     else
         return nullptr;
 }
@@ -357,7 +662,7 @@ GridMapCellPtr InternalGridMap::IndexToCell(const astar::GridCellIndex &index)
 void InternalGridMap::SetSimpleObstacle(int row, int col)
 {
     // occupy the given cell
-    // grid_map[row][col].occupancy = 1.0;
+    // grid_map[GRID_MAP_INDEX(row, col)].occupancy = 1.0;
 
     // set the obstacle in the voronoi diagram
     voronoi.SetSimpleObstacle(row, col);
@@ -367,7 +672,7 @@ void InternalGridMap::SetSimpleObstacle(int row, int col)
 void InternalGridMap::SetSimpleFreeSpace(int row, int col)
 {
     // occupy the given cell
-    // grid_map[row][col].occupancy = 0.0;
+    // grid_map[GRID_MAP_INDEX(row, col)].occupancy = 0.0;
 
     // set the obstacle in the voronoi diagram
     voronoi.SetSimpleFreeSpace(row, col);
@@ -379,10 +684,10 @@ void InternalGridMap::OccupyCell(int row, int col)
     // set the obstacle in the voronoi diagram
     voronoi.SetObstacle(row, col);
 
-    if (1.0 != grid_map[row][col].occupancy)
+    if (1.0 != grid_map[GRID_MAP_INDEX(row, col)].occupancy)
     {
         // occupy the given cell
-        grid_map[row][col].occupancy = 1.0;
+        grid_map[GRID_MAP_INDEX(row, col)].occupancy = 1.0;
     }
 }
 
@@ -392,10 +697,10 @@ void InternalGridMap::ClearCell(int row, int col)
     // remove the obstacle in the voronoi diagram
     voronoi.RemoveObstacle(row, col);
 
-    if (0.0 != grid_map[row][col].occupancy)
+    if (0.0 != grid_map[GRID_MAP_INDEX(row, col)].occupancy)
     {
         // clear the given cell
-        grid_map[row][col].occupancy = 0.0;
+        grid_map[GRID_MAP_INDEX(row, col)].occupancy = 0.0;
 
     }
 }
@@ -511,7 +816,7 @@ unsigned char* InternalGridMap::GetGridMap()
     {
         for (unsigned int col = 0; col < width; ++col)
         {
-            unsigned char c = (unsigned char) (grid_map[(unsigned int) row][col].occupancy == 0 ? 255 : 0);
+            unsigned char c = (unsigned char) (grid_map[GRID_MAP_INDEX((unsigned int) row, col)].occupancy == 0 ? 255 : 0);
 
             map[k] = c;
 
@@ -525,7 +830,7 @@ unsigned char* InternalGridMap::GetGridMap()
     {
         for (unsigned int j = 0; j < height; ++j)
         {
-            unsigned char c = (unsigned char) (grid_map[(unsigned int) i][j].occupancy == 0 ? 255 : 0);
+            unsigned char c = (unsigned char) (grid_map[GRID_MAP_INDEX((unsigned int) i, j)].occupancy == 0 ? 255 : 0);
 
             map[k] = c;
 
@@ -562,7 +867,7 @@ unsigned char* InternalGridMap::GetCorridorMap()
     {
         for (unsigned int j = 0; j < height; ++j)
         {
-            unsigned char c = (unsigned char) (grid_map[(unsigned int) i][j].is_corridor ? 255 : 0);
+            unsigned char c = (unsigned char) (grid_map[GRID_MAP_INDEX((unsigned int) i, j)].is_corridor ? 255 : 0);
 
             map[k] = c;
 
@@ -26,14 +26,43 @@
 #define INTERNAL_GRID_MAP_HPP
 
 #include <mutex>
+#include <vector>
 
 #include "GVDLau.hpp"
 #include "GridMapCell.hpp"
+#include "AlignedBuffer.hpp"
 #include "../Entities/State2D.hpp"
 #include "../Entities/Circle.hpp"
+#include "../Entities/VehicleFootprint.hpp"
 
 namespace astar {
 
+    // the voronoi diagram update metrics
+    // an incremental update cost scales with the number of changed cells and not with the map area
+    class GVDUpdateMetrics
+    {
+        public:
+
+            // how many cells were fed to the voronoi diagram
+            unsigned int changed_cells;
+
+            // the grid map size
+            unsigned int total_cells;
+
+            // the map dimensions or resolution have changed, so the diagram was rebuilt from scratch
+            bool full_rebuild;
+
+            // the window shift applied to the diagram when the map origin has changed, in cells
+            int row_shift, col_shift;
+
+            // the voronoi diagram update time, in seconds
+            double elapsed;
+
+            // basic constructor
+            GVDUpdateMetrics() : changed_cells(0), total_cells(0), full_rebuild(false), row_shift(0), col_shift(0), elapsed(0.0) {}
+
+    };
+
     class InternalGridMap
     {
 
@@ -68,18 +97,27 @@ namespace astar {
             // the Voronoi field  map
             astar::GVDLau voronoi;
 
+            // the cells whose occupied state changed in the last grid map update, flat row-stride indexes
+            std::vector<unsigned int> changed_cells;
+
+            // the last voronoi diagram update metrics
+            astar::GVDUpdateMetrics gvd_metrics;
+
             // PRIVATE METHODS
 
             // remove the current grid map
             void RemoveGridMap();
 
+            // update the map dimensions and origin, a new window resets or shifts the voronoi diagram
+            void UpdateGridMapConfig(unsigned int h, unsigned int w, double res, const astar::Vector2D<double> &_origin);
+
 
         public:
 
             // PUBLIC ATTRIBUTES
 
-            // the current grid map
-            astar::GridMap grid_map;
+            // the current grid map, row-stride contiguous storage, see GRID_MAP_INDEX
+            astar::AlignedBuffer<astar::GridMapCell> grid_map;
 
             // PUBLIC METHODS
 
@@ -93,8 +131,20 @@ namespace astar {
             void ProcessVoronoiDiagram();
 
             // initialize the grid map given the map dimensions
+            // an origin change shifts the voronoi diagram window, so only the entering strips are new
+            // the cells whose occupied state changed are saved to the next voronoi diagram update
             void UpdateGridMap(unsigned int w, unsigned int h, double res, const astar::Vector2D<double> &_origin, double *map);
 
+            // the same update from a sparse list of cells, the compact cost map, the cells not in the list are free
+            void UpdateCompactGridMap(unsigned int h, unsigned int w, double res, const astar::Vector2D<double> &_origin,
+                    unsigned int n, const int *rows, const int *cols, const double *values);
+
+            // feed only the changed cells to the voronoi diagram and process it
+            void UpdateVoronoiDiagram();
+
+            // get the last voronoi diagram update metrics
+            const astar::GVDUpdateMetrics& GetGVDMetrics() const;
+
             // verify if the current grid map has changed
             bool HasChanged() const;
 
@@ -113,6 +163,23 @@ namespace astar {
             // verify if a given pose is a valid one
             bool isSafePlace(const std::vector<astar::Circle> &body, double safety_factor);
 
+            // verify if the vehicle footprint at a given position and orientation is safe
+            // there's no allocation, it stops at the first unsafe circle
+            // the margin is added to the circle radius, it covers any known position error
+            bool isSafePlace(const astar::Vector2D<double> &position, double orientation, const astar::VehicleFootprint &footprint, double safety_factor, double margin = 0.0) const;
+
+            // verify if the vehicle footprint at a given pose is safe
+            bool isSafePlace(const astar::Pose2D &pose, const astar::VehicleFootprint &footprint, double safety_factor) const;
+
+            // get the smallest distance between the footprint circles and the unsafe region around the obstacles, in meters
+            // a negative value is an unsafe pose, the same decision as isSafePlace, a footprint outside the grid map gets -1
+            double GetClearance(const astar::Vector2D<double> &position, double orientation, const astar::VehicleFootprint &footprint, double safety_factor, double margin = 0.0) const;
+
+            // verify a batch of poses at once, up to 32 poses
+            // returns a mask with the bit i set if the pose i is safe
+            // it uses the SSE2 kernel if available, see the Makefile to force the scalar one
+            unsigned int CheckPoses(const astar::Pose2D *poses, unsigned int n, const astar::VehicleFootprint &footprint, double safety_factor) const;
+
             // get the grid cell index from any position
             astar::GridCellIndex PoseToIndex(const astar::Vector2D<double>&) const;
 
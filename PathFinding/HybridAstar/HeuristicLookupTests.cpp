@@ -0,0 +1,280 @@
+// the nearest cell against the interpolated nonholonomic heuristic lookup, the values against the Reeds-Shepp cost
+// at random poses and the node expansions of the same searches
+// g++ -std=c++11 -O2 -I../.. HeuristicLookupTests.cpp HybridAstar.cpp HybridAstarNode.cpp HybridAstarNodeArena.cpp HybridAstarClosedSet.cpp Heuristics/Heuristic.cpp Heuristics/HolonomicHeuristic.cpp Heuristics/NonholonomicHeuristicInfo.cpp ../../GridMap/InternalGridMap.cpp ../../GridMap/GVDLau.cpp ../../VehicleModel/VehicleModel.cpp ../../ReedsShepp/ReedsSheppModel.cpp ../../ReedsShepp/ReedsSheppActionSet.cpp ../../Entities/Pose2D.cpp ../../Entities/State2D.cpp ../../Entities/Circle.cpp `pkg-config --cflags --libs opencv`
+// ./a.out <pgm map> [scenarios] [lookup poses], the heuristic_info.bin file with the interpolation bounds must be in the current directory, see Heuristics/heuristic_calculator.cpp
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "HybridAstar.hpp"
+#include "Heuristics/NonholonomicHeuristicInfo.hpp"
+#include "Heuristics/Heuristic.hpp"
+#include "../../ReedsShepp/ReedsSheppModel.hpp"
+#include "../../Helpers/wrap2pi.hpp"
+
+// load the PGM file
+void loadPGM(std::istream &is, int *sizeX, int *sizeY, std::vector<double> &map)
+{
+	std::string tag;
+
+	is >> tag;
+	if (tag!="P5")
+	{
+		std::cerr << "Awaiting 'P5' in pgm header, found " << tag << std::endl;
+		exit(-1);
+	}
+
+	while (is.peek()==' ' || is.peek()=='\n') is.ignore();
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> *sizeX;
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> *sizeY;
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> tag;
+	if (tag!="255")
+	{
+		std::cerr << "Awaiting '255' in pgm header, found " << tag << std::endl;
+		exit(-1);
+	}
+	is.ignore(255, '\n');
+
+	// the carmen maps are column major
+	map.assign((*sizeX) * (*sizeY), 0.0);
+
+	for (int y = *sizeY-1; y >= 0; --y)
+	{
+		for (int x = 0; x < *sizeX; ++x)
+		{
+			int c = is.get();
+
+			// cell is occupied
+			if ((double) c < 255-255*0.2) map[x * (*sizeY) + y] = 1.0;
+
+			if (!is.good())
+			{
+				std::cerr << "Error reading pgm map.\n";
+				exit(-1);
+			}
+		}
+	}
+}
+
+// the elapsed time in milliseconds
+double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// compare both lookups to the Reeds-Shepp cost at random start and goal poses, through the same heuristic the search uses
+// the starts cover the nearest lookup range around each goal, the border cells included
+// returns how many interpolated values are above the cost
+unsigned int LookupCheck(astar::InternalGridMap &grid, unsigned int samples)
+{
+	astar::Heuristic heuristic(grid);
+
+	astar::NonholonomicHeuristicInfo info;
+	astar::NonholonomicHeuristicInfo::Load(info, "heuristic_info.bin");
+
+	double extent = info.position_offset + 0.5 * info.resolution;
+
+	std::mt19937 generator(31);
+	std::uniform_real_distribution<double> p(-extent, extent), g(-200.0, 200.0), t(-M_PI, M_PI);
+
+	std::vector<astar::Pose2D> starts(samples), goals(samples);
+	std::vector<double> costs(samples);
+
+	astar::ReedsSheppModel rs;
+
+	for (unsigned int i = 0; i < samples; ++i)
+	{
+		astar::Pose2D &goal(goals[i]);
+		goal = astar::Pose2D(g(generator), g(generator), t(generator));
+
+		// the start in the goal frame, moved to the world frame
+		double px = p(generator), py = p(generator);
+		double c = std::cos(goal.orientation), s = std::sin(goal.orientation);
+
+		starts[i] = astar::Pose2D(goal.position.x + c * px - s * py, goal.position.y + s * px + c * py, mrpt::math::wrapToPi<double>(goal.orientation + t(generator)));
+
+		costs[i] = rs.Distance(starts[i], goal, info.turn_radius, 1.0, 0.0);
+	}
+
+	unsigned int nearest_above = 0, interpolated_above = 0;
+	double nearest_excess = 0.0, interpolated_excess = 0.0, nearest_gap = 0.0, interpolated_gap = 0.0;
+
+	for (unsigned int k = 0; k < 2; ++k)
+	{
+		heuristic.SetInterpolation(1 == k);
+
+		unsigned int &above(0 == k ? nearest_above : interpolated_above);
+		double &excess(0 == k ? nearest_excess : interpolated_excess);
+		double &gap(0 == k ? nearest_gap : interpolated_gap);
+
+		for (unsigned int i = 0; i < samples; ++i)
+		{
+			double value = heuristic.GetObstacleRelaxedHeuristicValue(starts[i], goals[i]);
+
+			gap += costs[i] - value;
+
+			if (value > costs[i])
+			{
+				above++;
+				excess = std::max(excess, value - costs[i]);
+			}
+		}
+	}
+
+	std::cout << "Lookups against the Reeds-Shepp cost at " << samples << " random start and goal poses\n";
+	std::cout << "  nearest lookup:      " << nearest_above << " above the cost, up to " << nearest_excess << " m, mean gap " << nearest_gap / samples << " m\n";
+	std::cout << "  interpolated lookup: " << interpolated_above << " above the cost, up to " << interpolated_excess << " m, mean gap " << interpolated_gap / samples << " m\n\n";
+
+	return interpolated_above;
+}
+
+// a single search result
+class SearchResult
+{
+	public:
+
+		// how many expanded nodes
+		unsigned int expanded;
+
+		// the search time
+		double time;
+
+		// the path size, zero if there's no path
+		unsigned int states;
+};
+
+// run a single search, the Reeds-Shepp shots use rand(), so the seed is reset before each search
+SearchResult Search(astar::HybridAstar &search, astar::InternalGridMap &grid, const astar::State2D &start, const astar::State2D &goal, unsigned int seed)
+{
+	SearchResult result;
+
+	srand(seed);
+
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	astar::StateArrayPtr path = search.FindPath(grid, start, goal);
+	result.time = ElapsedMilliseconds(t0);
+
+	result.expanded = search.GetExpandedNodes();
+	result.states = path->states.size();
+
+	delete path;
+
+	return result;
+}
+
+int main (int argc, char **argv)
+{
+	if (2 > argc)
+	{
+		std::cerr << "usage: " << argv[0] << " <pgm map> [scenarios] [lookup poses]\n";
+		exit(-1);
+	}
+
+	std::ifstream is(argv[1]);
+	if (!is.is_open())
+	{
+		std::cerr << "Could not open map file for reading.\n";
+		exit(-1);
+	}
+
+	unsigned int scenarios = 2 < argc ? std::atoi(argv[2]) : 50;
+	unsigned int samples = 3 < argc ? std::atoi(argv[3]) : 1000000;
+
+	int width, height;
+	std::vector<double> map;
+
+	loadPGM(is, &width, &height, map);
+	is.close();
+
+	// the grid map, 0.2 m cells
+	double resolution = 0.2;
+	astar::InternalGridMap grid;
+	grid.UpdateGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), &map[0]);
+	grid.UpdateVoronoiDiagram();
+
+	// the interpolated values must not be above the cost
+	unsigned int failures = LookupCheck(grid, samples);
+
+	// the ford escape parameters
+	astar::VehicleModel vehicle;
+	vehicle.length = 4.425;
+	vehicle.width = 1.806;
+	vehicle.axledist = 2.625;
+	vehicle.rear_car_wheels_dist = 0.96;
+	vehicle.max_wheel_deflection = 0.5337;
+	vehicle.understeer = 0.0015;
+	vehicle.max_curvature = 0.22;
+	vehicle.safety_factor = 1.0;
+	vehicle.Configure();
+
+	// the same searches with both lookups
+	astar::HybridAstar nearest(vehicle, grid), interpolated(vehicle, grid);
+	interpolated.SetInterpolatedHeuristic(true);
+
+	// the scenario set, safe start and goal poses between 10 and 40 meters apart
+	std::mt19937 generator(19);
+	std::uniform_real_distribution<double> x(0.0, width * resolution), y(0.0, height * resolution), t(-M_PI, M_PI);
+
+	unsigned int both_found = 0, fewer = 0, more = 0;
+	unsigned long nearest_expanded = 0, interpolated_expanded = 0;
+	double nearest_time = 0.0, interpolated_time = 0.0;
+
+	std::cout << "scenario, nearest expanded, interpolated expanded, nearest ms, interpolated ms\n";
+
+	for (unsigned int i = 0; i < scenarios;)
+	{
+		astar::State2D start, goal;
+
+		start.position = astar::Vector2D<double>(x(generator), y(generator));
+		start.orientation = t(generator);
+		goal.position = astar::Vector2D<double>(x(generator), y(generator));
+		goal.orientation = t(generator);
+
+		double distance = start.position.Distance(goal.position);
+
+		if (10.0 > distance || 40.0 < distance ||
+			!grid.isSafePlace(start.position, start.orientation, vehicle.footprint, vehicle.safety_factor) ||
+			!grid.isSafePlace(goal.position, goal.orientation, vehicle.footprint, vehicle.safety_factor))
+		{
+			continue;
+		}
+
+		// the first step length
+		start.v = 1.0;
+		start.t = resolution;
+
+		SearchResult a = Search(nearest, grid, start, goal, i);
+		SearchResult b = Search(interpolated, grid, start, goal, i);
+
+		std::cout << i << ", " << a.expanded << ", " << b.expanded << ", " << a.time << ", " << b.time << (0 == a.states || 0 == b.states ? ", no path\n" : "\n");
+
+		if (0 < a.states && 0 < b.states)
+		{
+			both_found++;
+			nearest_expanded += a.expanded;
+			interpolated_expanded += b.expanded;
+			nearest_time += a.time;
+			interpolated_time += b.time;
+
+			fewer += b.expanded < a.expanded ? 1 : 0;
+			more += b.expanded > a.expanded ? 1 : 0;
+		}
+
+		++i;
+	}
+
+	std::cout << "\nBoth lookups found a path in " << both_found << " of " << scenarios << " scenarios\n";
+	std::cout << "  nearest lookup:      " << nearest_expanded << " expanded nodes, " << nearest_time << " ms\n";
+	std::cout << "  interpolated lookup: " << interpolated_expanded << " expanded nodes, " << interpolated_time << " ms\n";
+	std::cout << "  the interpolated lookup expanded fewer nodes in " << fewer << " scenarios and more nodes in " << more << "\n";
+
+	return 0 == failures ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#ifndef HYBRID_ASTAR_CIRCLE_PATH_INDEX_HPP
+#define HYBRID_ASTAR_CIRCLE_PATH_INDEX_HPP
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "../../../Entities/Vector2D.hpp"
+
+namespace astar {
+
+// a uniform grid hash over the circle path centers
+// the nearest center query visits the buckets in rings around the query bucket and stops
+// as soon as the next ring can't hold a closer center, so the cost depends on the distance to the path, not on the path size
+class CirclePathIndex {
+
+    private:
+
+        // PRIVATE ATTRIBUTES
+
+        // the circle centers, in the circle path order
+        std::vector<astar::Vector2D<double>> centers;
+
+        // the first center index inside each bucket, the last entry closes the last bucket
+        std::vector<unsigned int> bucket_start;
+
+        // the center indexes sorted by bucket, ascending inside each bucket
+        std::vector<unsigned int> bucket_centers;
+
+        // the grid origin, the lower left corner of the bounding box
+        astar::Vector2D<double> origin;
+
+        // the bucket size and its inverse
+        double bucket_size, inverse_bucket_size;
+
+        // the grid dimensions
+        int cols, rows;
+
+        // PRIVATE METHODS
+
+        // visit a given bucket and update the nearest center
+        void VisitBucket(int col, int row, const astar::Vector2D<double> &position, unsigned int &nearest, double &distance2) const {
+
+            if (0 <= col && col < cols && 0 <= row && row < rows) {
+
+                // the bucket index
+                unsigned int b = row * cols + col;
+
+                for (unsigned int i = bucket_start[b]; i < bucket_start[b + 1]; ++i) {
+
+                    // the center index
+                    unsigned int c = bucket_centers[i];
+
+                    double d2 = position.Distance2(centers[c]);
+
+                    // the lowest index wins the ties, just like a linear search along the path
+                    if (d2 < distance2 || (d2 == distance2 && c < nearest)) {
+
+                        distance2 = d2;
+                        nearest = c;
+
+                    }
+
+                }
+
+            }
+
+        }
+
+    public:
+
+        // PUBLIC METHODS
+
+        // basic constructor
+        CirclePathIndex() : centers(), bucket_start(), bucket_centers(), origin(), bucket_size(1.0), inverse_bucket_size(1.0), cols(0), rows(0) {}
+
+        // rebuild the index, the memory is kept across the rebuilds
+        void Build(const std::vector<astar::Vector2D<double>> &path) {
+
+            centers = path;
+
+            bucket_start.clear();
+            bucket_centers.clear();
+            cols = rows = 0;
+
+            if (centers.empty()) {
+
+                return;
+
+            }
+
+            // the bounding box and the path length
+            astar::Vector2D<double> lower(centers[0]), upper(centers[0]);
+            double length = 0.0;
+
+            for (unsigned int i = 1; i < centers.size(); ++i) {
+
+                lower.x = std::min(lower.x, centers[i].x);
+                lower.y = std::min(lower.y, centers[i].y);
+                upper.x = std::max(upper.x, centers[i].x);
+                upper.y = std::max(upper.y, centers[i].y);
+
+                length += centers[i].Distance(centers[i - 1]);
+
+            }
+
+            // the buckets are as large as two consecutive circles gaps, so a bucket holds a few centers
+            bucket_size = std::max(1.0, 2.0 * length / centers.size());
+
+            // a winding path may cover a large bounding box, the bucket count is kept proportional to the path size
+            unsigned long max_buckets = std::max(1024ul, 64ul * centers.size());
+
+            while (true) {
+
+                cols = static_cast<int>((upper.x - lower.x) / bucket_size) + 1;
+                rows = static_cast<int>((upper.y - lower.y) / bucket_size) + 1;
+
+                if (static_cast<unsigned long>(cols) * rows <= max_buckets) {
+
+                    break;
+
+                }
+
+                bucket_size *= 2.0;
+
+            }
+
+            inverse_bucket_size = 1.0 / bucket_size;
+            origin = lower;
+
+            // counting sort, the centers keep the path order inside each bucket
+            bucket_start.assign(cols * rows + 1, 0);
+            bucket_centers.resize(centers.size());
+
+            std::vector<unsigned int> bucket(centers.size());
+
+            for (unsigned int i = 0; i < centers.size(); ++i) {
+
+                int col = std::min(cols - 1, static_cast<int>((centers[i].x - origin.x) * inverse_bucket_size));
+                int row = std::min(rows - 1, static_cast<int>((centers[i].y - origin.y) * inverse_bucket_size));
+
+                bucket[i] = row * cols + col;
+                bucket_start[bucket[i] + 1]++;
+
+            }
+
+            for (unsigned int b = 0; b < bucket_start.size() - 1; ++b) {
+
+                bucket_start[b + 1] += bucket_start[b];
+
+            }
+
+            std::vector<unsigned int> next(bucket_start.begin(), bucket_start.end() - 1);
+
+            for (unsigned int i = 0; i < centers.size(); ++i) {
+
+                bucket_centers[next[bucket[i]]++] = i;
+
+            }
+
+        }
+
+        // the number of indexed centers
+        unsigned int Size() const {
+
+            return centers.size();
+
+        }
+
+        // get the nearest center index, the index must not be empty
+        unsigned int Nearest(const astar::Vector2D<double> &position) const {
+
+            // the query bucket, it may be outside the grid
+            double fc = std::floor((position.x - origin.x) * inverse_bucket_size);
+            double fr = std::floor((position.y - origin.y) * inverse_bucket_size);
+
+            // avoid the integer overflow with far away queries
+            int col = static_cast<int>(std::max(-1.0, std::min(static_cast<double>(cols), fc)));
+            int row = static_cast<int>(std::max(-1.0, std::min(static_cast<double>(rows), fr)));
+
+            // the first ring that touches the grid
+            int dc = col < 0 ? -col : (cols <= col ? col - cols + 1 : 0);
+            int dr = row < 0 ? -row : (rows <= row ? row - rows + 1 : 0);
+            int first = std::max(dc, dr);
+
+            // the last ring that touches the grid
+            int last = std::max(std::max(col, cols - 1 - col), std::max(row, rows - 1 - row));
+
+            unsigned int nearest = 0;
+            double distance2 = std::numeric_limits<double>::infinity();
+
+            for (int k = first; k <= last; ++k) {
+
+                // the ring sides, clipped to the grid
+                int c0 = std::max(0, col - k), c1 = std::min(cols - 1, col + k);
+                int r0 = std::max(0, row - k + 1), r1 = std::min(rows - 1, row + k - 1);
+
+                // the bottom and top sides
+                for (int c = c0; c <= c1; ++c) {
+
+                    VisitBucket(c, row - k, position, nearest, distance2);
+
+                    if (0 < k) {
+
+                        VisitBucket(c, row + k, position, nearest, distance2);
+
+                    }
+
+                }
+
+                // the left and right sides, without the corners
+                for (int r = r0; 0 < k && r <= r1; ++r) {
+
+                    VisitBucket(col - k, r, position, nearest, distance2);
+                    VisitBucket(col + k, r, position, nearest, distance2);
+
+                }
+
+                // the centers beyond the current ring are at least k buckets away from the query bucket borders
+                // the clamped far away queries are even farther, so the bound is still valid
+                double bound = k * bucket_size;
+
+                if (distance2 < bound * bound) {
+
+                    break;
+
+                }
+
+            }
+
+            return nearest;
+
+        }
+
+};
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+// the circle path grid hash against the old linear nearest circle search, long corridor circle paths
+// g++ -std=c++11 -O2 -I../../.. CirclePathIndexTests.cpp
+// ./a.out
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "CirclePathIndex.hpp"
+
+// the elapsed time in nanoseconds
+double ElapsedNanoseconds(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the old stupid search, the first nearest circle along the path
+unsigned int LinearNearest(const std::vector<astar::Vector2D<double>> &centers, const astar::Vector2D<double> &position)
+{
+	unsigned int nearest = 0;
+	double distance = position.Distance(centers[0]);
+
+	for (unsigned int i = 1; i < centers.size(); ++i)
+	{
+		double d = position.Distance(centers[i]);
+
+		if (d < distance)
+		{
+			distance = d;
+			nearest = i;
+		}
+	}
+
+	return nearest;
+}
+
+// a serpentine corridor, parallel legs joined by half turns, the circles follow the corridor center line
+// the circle radius changes along the corridor, just like the obstacle distance along a real circle path
+void BuildCorridor(unsigned int legs, double leg_length, double leg_gap, std::mt19937 &generator, std::vector<astar::Vector2D<double>> &centers)
+{
+	std::uniform_real_distribution<double> radius(1.5, 4.0);
+
+	centers.clear();
+
+	for (unsigned int l = 0; l < legs; ++l)
+	{
+		double y = l * leg_gap;
+		bool forward = 0 == (l & 1);
+
+		// the straight leg
+		for (double s = 0.0; s < leg_length; s += radius(generator))
+		{
+			centers.push_back(astar::Vector2D<double>(forward ? s : leg_length - s, y));
+		}
+
+		// the half turn to the next leg
+		if (l + 1 < legs)
+		{
+			double r = leg_gap * 0.5;
+			double cx = forward ? leg_length : 0.0;
+
+			for (double a = 0.0; a < M_PI; a += radius(generator) / r)
+			{
+				double side = forward ? 1.0 : -1.0;
+				centers.push_back(astar::Vector2D<double>(cx + side * r * std::sin(a), y + r - r * std::cos(a)));
+			}
+		}
+	}
+}
+
+int main ()
+{
+	std::mt19937 generator(20);
+
+	// the corridor sizes, from a short circle path up to several thousands of circles
+	const unsigned int legs[] = {1, 4, 16, 32};
+	const unsigned int N = 200000;
+
+	for (unsigned int t = 0; t < sizeof(legs) / sizeof(legs[0]); ++t)
+	{
+		std::vector<astar::Vector2D<double>> centers;
+		BuildCorridor(legs[t], 1000.0, 20.0, generator, centers);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		astar::CirclePathIndex index;
+		index.Build(centers);
+		double build_time = ElapsedNanoseconds(start);
+
+		// the expanded nodes are around the corridor, a few are anywhere in the map
+		std::vector<astar::Vector2D<double>> queries(N);
+		std::uniform_int_distribution<unsigned int> around(0, centers.size() - 1);
+		std::normal_distribution<double> offset(0.0, 5.0);
+		std::uniform_real_distribution<double> map_x(-50.0, 1050.0), map_y(-50.0, legs[t] * 20.0 + 50.0);
+
+		for (unsigned int i = 0; i < N; ++i)
+		{
+			if (0 == i % 100)
+			{
+				queries[i] = astar::Vector2D<double>(map_x(generator), map_y(generator));
+			}
+			else
+			{
+				const astar::Vector2D<double> &c(centers[around(generator)]);
+				queries[i] = astar::Vector2D<double>(c.x + offset(generator), c.y + offset(generator));
+			}
+		}
+
+		std::vector<unsigned int> linear(N), hashed(N);
+
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < N; ++i)
+		{
+			linear[i] = LinearNearest(centers, queries[i]);
+		}
+		double linear_time = ElapsedNanoseconds(start) / N;
+
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < N; ++i)
+		{
+			hashed[i] = index.Nearest(queries[i]);
+		}
+		double hashed_time = ElapsedNanoseconds(start) / N;
+
+		// the same circle or at least the same distance
+		unsigned int diffs = 0;
+		for (unsigned int i = 0; i < N; ++i)
+		{
+			diffs += linear[i] != hashed[i] && queries[i].Distance(centers[linear[i]]) != queries[i].Distance(centers[hashed[i]]) ? 1 : 0;
+		}
+
+		std::cout << "Corridor with " << legs[t] << " legs, " << centers.size() << " circles, index built in " << build_time / 1000.0 << " us\n";
+		std::cout << "  linear search per query: " << linear_time << " ns\n";
+		std::cout << "  grid hash per query:     " << hashed_time << " ns, " << diffs << " different nearest distances\n";
+	}
+
+	return 0;
+}
@@ -3,15 +3,20 @@
 #include "../../../PriorityQueue/PriorityQueue.hpp"
 
 #include <set>
+#include <fstream>
+#include <iostream>
 #include <cmath>
 
 using namespace astar;
 
 // basic constructor
-astar::Heuristic::Heuristic(InternalGridMapRef map) : info(), holonomic(map) {
+astar::Heuristic::Heuristic(InternalGridMapRef map) : info(), holonomic(map), goal(), interpolate(false) {
+
+    // the binary table is mapped, the old text table is still accepted
+    std::ifstream binary("heuristic_info.bin");
 
     // load the external heuristic file
-    NonholonomicHeuristicInfo::Load(info, "heuristic_info.txt");
+    NonholonomicHeuristicInfo::Load(info, binary.good() ? "heuristic_info.bin" : "heuristic_info.txt");
 
 }
 
@@ -22,14 +27,28 @@ double Heuristic::GetObstacleRelaxedHeuristicValue(Pose2D start_, const Pose2D &
     start_.position.Subtract(goal_.position);
     start_.position.RotateZ(-goal_.orientation);
 
-    // get the angle displacement
-    start_.orientation = mrpt::math::angDistance<double>(start_.orientation, goal_.orientation);
+    // the start heading in the goal frame, the table is indexed by the start heading relative to the goal
+    start_.orientation = mrpt::math::angDistance<double>(goal_.orientation, start_.orientation);
+
+    // the interpolated lookup, inside the table range
+    double value;
+
+    if (interpolate && info.GetInterpolatedValue(start_.position.x, start_.position.y, start_.orientation, value)) {
+
+        return value;
+
+    }
 
     // get the indexes in the heuristic table
     int row = (int) std::floor((start_.position.y + info.position_offset) / info.resolution + 0.5);
     int col = (int) std::floor((start_.position.x + info.position_offset) / info.resolution + 0.5);
     int o = (int) std::floor(start_.orientation / info.orientation_offset + 0.5);
 
+    // the relative heading is in [-pi, pi], the table bins are in [0, 2pi)
+    if (0 > o) {
+        o += info.orientations;
+    }
+
     if (o == info.orientations) {
         o = 0;
     }
@@ -41,7 +60,7 @@ double Heuristic::GetObstacleRelaxedHeuristicValue(Pose2D start_, const Pose2D &
 
     }
 
-    return info.heuristic[row][col][o];
+    return info.GetValue(row, col, o);
 
 }
 
@@ -54,6 +73,21 @@ double Heuristic::GetNonholonomicRelaxedHeuristicValue(const Pose2D &start) {
 
 }
 
+// enable or disable the interpolated nonholonomic lookup
+void astar::Heuristic::SetInterpolation(bool flag) {
+
+    if (flag && !info.HasInterpolationBounds()) {
+
+        std::cout << "The heuristic table has no interpolation bounds, keeping the nearest cell lookup\n";
+
+        flag = false;
+
+    }
+
+    interpolate = flag;
+
+}
+
 // find a new circel path connecting the start and goal poses
 void astar::Heuristic::UpdateHeuristic(astar::InternalGridMap &grid, const Pose2D &start_, const Pose2D &goal_) {
 
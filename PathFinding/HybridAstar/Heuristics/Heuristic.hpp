@@ -50,10 +50,11 @@ class Heuristic {
         // the next goal, updates the circle path heuristic
         astar::Pose2D goal;
 
-        // PRIVATE METHODS
+        // use the interpolated nonholonomic lookup instead of the nearest cell
+        // the nearest cell may be above the Reeds-Shepp cost, the interpolated value is below it within a verified margin
+        bool interpolate;
 
-        // obstacle relaxed heuristic
-        double GetObstacleRelaxedHeuristicValue(astar::Pose2D, const astar::Pose2D&);
+        // PRIVATE METHODS
 
         // nonholonomic relaxed heuristic
         double GetNonholonomicRelaxedHeuristicValue(const astar::Pose2D&);
@@ -67,9 +68,16 @@ class Heuristic {
         // basic constructor
         Heuristic(astar::InternalGridMapRef);
 
+        // enable or disable the interpolated nonholonomic lookup
+        // the table needs the interpolation bounds, without them the nearest cell lookup is kept
+        void SetInterpolation(bool);
+
         // update the heuristic around a new goal
         void UpdateHeuristic(astar::InternalGridMap& map, const astar::Pose2D&, const astar::Pose2D&);
 
+        // obstacle relaxed heuristic, the nonholonomic table lookup alone
+        double GetObstacleRelaxedHeuristicValue(astar::Pose2D, const astar::Pose2D&);
+
         // get a heuristic value
         double GetHeuristicValue(const astar::Pose2D&, const astar::Pose2D&);
 
@@ -28,6 +28,14 @@
 #include <cmath>
 #include <limits>
 #include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include "../../../ReedsShepp/ReedsSheppModel.hpp"
 #include "NonholonomicHeuristicInfo.hpp"
@@ -41,16 +49,358 @@ class HeuristicCalculator {
 
         // PRIVATE ATTRIBUTES
 
+        // the safety margin added to every interpolation bound, in cells
+        // the bound is sampled at the cell centers and the Reeds-Shepp cost is not smooth, so the sampled bound misses the
+        // peaks between the samples (0.05% of the random poses, up to 0.09 m): each cell takes the largest bound of its
+        // neighbors, which leaves 0.004% up to 0.03 m, and the margin covers the rest
+        // it's a verified margin, not a derived one, see HeuristicLookupTests
+        static constexpr double BoundMargin = 0.5;
+
+        // the checkpoint file header, the checkpoint is discarded if any parameter doesn't match
+        class CheckpointHeader {
+
+            public:
+
+                // the file tag and version
+                char tag[4];
+                uint32_t version;
+
+                // the table parameters
+                uint32_t num_cells;
+                uint32_t orientations;
+                double neighborhood_size;
+                double resolution;
+                double turn_radius;
+
+        };
+
         // PRIVATE METHODS
 
-    public:
+        // build the checkpoint header of a given table
+        static CheckpointHeader GetCheckpointHeader(const astar::NonholonomicHeuristicInfo &info, double vehicle_turn_radius) {
 
-        // compute the non-holonomic without obstacles heuristic around a given neihgborhood
-        static astar::NonholonomicHeuristicInfo* Calculate(double neighborhoodSize, double resolution, int orientations, double vehicle_turn_radius) {
+            CheckpointHeader header;
+
+            header.tag[0] = 'N';
+            header.tag[1] = 'H';
+            header.tag[2] = 'C';
+            header.tag[3] = 'P';
+            header.version = 3;
+            header.num_cells = info.num_cells;
+            header.orientations = info.orientations;
+            header.neighborhood_size = info.neighborhood_size;
+            header.resolution = info.resolution;
+            header.turn_radius = vehicle_turn_radius;
+
+            return header;
+
+        }
+
+        // the checkpoint record of a quadrant row: the row index followed by the quadrant columns costs
+        static void WriteCheckpointRow(std::ofstream &file, const astar::NonholonomicHeuristicInfo &info, uint32_t r) {
+
+            unsigned int half = info.num_cells / 2;
+
+            file.write(reinterpret_cast<const char*>(&r), sizeof(r));
+
+            // the quadrant columns are contiguous
+            file.write(reinterpret_cast<const char*>(info.heuristic + (r * info.num_cells + half) * info.orientations), (info.num_cells - half) * info.orientations * sizeof(float));
+
+        }
+
+        // read the complete rows of a previous checkpoint, a truncated last record is ignored
+        // the done flags are indexed by the quadrant row, returns how many rows were recovered
+        static unsigned int LoadCheckpoint(const std::string &filename, astar::NonholonomicHeuristicInfo &info, double vehicle_turn_radius, std::vector<char> &done) {
+
+            std::ifstream file(filename, std::ios::binary);
+
+            if (!file.is_open()) {
+
+                return 0;
+
+            }
+
+            // the expected and the saved headers
+            CheckpointHeader expected(GetCheckpointHeader(info, vehicle_turn_radius)), saved;
+
+            if (!file.read(reinterpret_cast<char*>(&saved), sizeof(saved)) ||
+                    0 != std::char_traits<char>::compare(expected.tag, saved.tag, 4) ||
+                    expected.version != saved.version ||
+                    expected.num_cells != saved.num_cells ||
+                    expected.orientations != saved.orientations ||
+                    expected.neighborhood_size != saved.neighborhood_size ||
+                    expected.resolution != saved.resolution ||
+                    expected.turn_radius != saved.turn_radius) {
+
+                std::cout << "Ignoring the checkpoint " << filename << ", different table parameters\n";
+
+                return 0;
+
+            }
+
+            unsigned int half = info.num_cells / 2;
+            unsigned int recovered = 0;
+
+            // a whole record buffer, so a truncated record doesn't touch the table
+            std::vector<float> row((info.num_cells - half) * info.orientations);
+
+            uint32_t r;
+
+            while (file.read(reinterpret_cast<char*>(&r), sizeof(r)) && file.read(reinterpret_cast<char*>(&row[0]), row.size() * sizeof(float))) {
+
+                if (half > r || info.num_cells <= r) {
+
+                    // not a quadrant row, the file is broken
+                    break;
+
+                }
+
+                std::copy(row.begin(), row.end(), info.GetCosts(r, half));
+
+                if (0 == done[r - half]) {
+
+                    done[r - half] = 1;
+
+                    recovered++;
+
+                }
 
-            //build a RS Model
+            }
+
+            return recovered;
+
+        }
+
+        // compute the quadrant rows in the pending list, the rows are shared among the threads
+        static void CalculateRows(
+                astar::NonholonomicHeuristicInfo &info,
+                double vehicle_turn_radius,
+                const std::vector<unsigned int> &pending,
+                std::atomic<unsigned int> &next,
+                std::mutex &checkpoint_mutex,
+                std::ofstream &checkpoint) {
+
+            // build a RS Model
             astar::ReedsSheppModel rs;
 
+            // the goal pose at the origin
+            astar::Pose2D goal(0.0, 0.0, 0.0);
+
+            // the first quadrant column
+            unsigned int half = info.num_cells / 2;
+
+            // the start poses and the costs of a quadrant row
+            std::vector<astar::Pose2D> poses((info.num_cells - half) * info.orientations);
+            std::vector<double> costs(poses.size());
+
+            for (unsigned int k = next++; k < pending.size(); k = next++) {
+
+                unsigned int r = pending[k];
+
+                for (unsigned int c = half, i = 0; c < info.num_cells; ++c) {
+
+                    for (unsigned int o = 0; o < info.orientations; ++o, ++i) {
+
+                        // get the pose values
+                        poses[i].position.x = c * info.resolution - info.position_offset;
+                        poses[i].position.y = r * info.resolution - info.position_offset;
+                        poses[i].orientation = o * info.orientation_offset;
+
+                    }
+
+                }
+
+                // Reeds-Shepp heuristic computation, only the length is needed
+                rs.Distance(&poses[0], poses.size(), goal, vehicle_turn_radius, 1.0, 0.0, &costs[0]);
+
+                // the quadrant columns are contiguous
+                float *row = info.GetCosts(r, half);
+
+                for (unsigned int i = 0; i < costs.size(); ++i) {
+
+                    row[i] = astar::NonholonomicHeuristicInfo::ToFloat(costs[i]);
+
+                }
+
+                // save the row, the flush keeps it even if the process is killed
+                std::lock_guard<std::mutex> lock(checkpoint_mutex);
+
+                if (checkpoint.is_open()) {
+
+                    WriteCheckpointRow(checkpoint, info, r);
+
+                    checkpoint.flush();
+
+                }
+
+            }
+
+        }
+
+        // compute the interpolation bounds of the quadrant cells in the pending list, the rows are shared among the threads
+        // the interpolated value is compared to the Reeds-Shepp cost at the center of each cell, for all orientations
+        // the last row and column cells cover only the half cell before the table border
+        static void CalculateBoundRows(
+                astar::NonholonomicHeuristicInfo &info,
+                double vehicle_turn_radius,
+                float *bounds,
+                const std::vector<unsigned int> &pending,
+                std::atomic<unsigned int> &next) {
+
+            // build a RS Model
+            astar::ReedsSheppModel rs;
+
+            // the goal pose at the origin
+            astar::Pose2D goal(0.0, 0.0, 0.0);
+
+            unsigned int half = info.num_cells / 2;
+            unsigned int quadrant_cells = info.num_cells - half;
+            unsigned int orientations = info.orientations;
+
+            // the samples of a quadrant row
+            std::vector<astar::Pose2D> poses(quadrant_cells * orientations);
+            std::vector<double> costs(poses.size());
+
+            for (unsigned int k = next++; k < pending.size(); k = next++) {
+
+                unsigned int r = pending[k];
+
+                // the sample weights, the border cells are only half a cell wide
+                double dr = r + 1 < info.num_cells ? 0.5 : 0.25;
+
+                for (unsigned int c = half, i = 0; c < info.num_cells; ++c) {
+
+                    double dc = c + 1 < info.num_cells ? 0.5 : 0.25;
+
+                    for (unsigned int o = 0; o < orientations; ++o, ++i) {
+
+                        poses[i].position.x = (c + dc) * info.resolution - info.position_offset;
+                        poses[i].position.y = (r + dr) * info.resolution - info.position_offset;
+                        poses[i].orientation = (o + 0.5) * info.orientation_offset;
+
+                    }
+
+                }
+
+                rs.Distance(&poses[0], poses.size(), goal, vehicle_turn_radius, 1.0, 0.0, &costs[0]);
+
+                for (unsigned int c = half, i = 0; c < info.num_cells; ++c) {
+
+                    double dc = c + 1 < info.num_cells ? 0.5 : 0.25;
+
+                    // the largest interpolation excess in the cell
+                    double excess = 0.0;
+
+                    for (unsigned int o = 0; o < orientations; ++o, ++i) {
+
+                        excess = std::max(excess, info.Interpolate(r, c, o, dr, dc, 0.5) - costs[i]);
+
+                    }
+
+                    bounds[(r - half) * quadrant_cells + c - half] = static_cast<float>(excess);
+
+                }
+
+            }
+
+        }
+
+        // spread each sampled bound over the neighbor cells and add the safety margin, rounding up
+        // the cells before the first quadrant row and column are the mirrored ones, the first row and column themselves
+        static void DilateBounds(const astar::NonholonomicHeuristicInfo &info, float *bounds) {
+
+            int quadrant_cells = info.num_cells - info.num_cells / 2;
+
+            std::vector<float> sampled(bounds, bounds + quadrant_cells * quadrant_cells);
+
+            double margin = BoundMargin * info.resolution;
+
+            for (int r = 0; r < quadrant_cells; ++r) {
+
+                for (int c = 0; c < quadrant_cells; ++c) {
+
+                    double excess = 0.0;
+
+                    for (int i = std::max(r - 1, 0); i <= std::min(r + 1, quadrant_cells - 1); ++i) {
+
+                        for (int j = std::max(c - 1, 0); j <= std::min(c + 1, quadrant_cells - 1); ++j) {
+
+                            excess = std::max(excess, static_cast<double>(sampled[i * quadrant_cells + j]));
+
+                        }
+
+                    }
+
+                    excess += margin;
+
+                    float bound = static_cast<float>(excess);
+
+                    if (bound < excess) {
+
+                        bound = std::nextafter(bound, std::numeric_limits<float>::infinity());
+
+                    }
+
+                    bounds[r * quadrant_cells + c] = bound;
+
+                }
+
+            }
+
+        }
+
+        // fill the other three quadrants, the goal is at the origin with zero orientation:
+        // the reflection (x, -y, -t) and the time flip (-x, y, -t) of a start pose have the same Reeds-Shepp length
+        static void MirrorQuadrant(astar::NonholonomicHeuristicInfo &info) {
+
+            unsigned int n = info.num_cells;
+            unsigned int half = n / 2;
+            unsigned int orientations = info.orientations;
+
+            for (unsigned int r = half; r < n; ++r) {
+
+                for (unsigned int c = half; c < n; ++c) {
+
+                    // the first quadrant costs
+                    const float *cost = info.GetCosts(r, c);
+
+                    // the mirrored cells, the center row and column are mirrored over themselves
+                    float *reflected = info.GetCosts(n - 1 - r, c);
+                    float *flipped = info.GetCosts(r, n - 1 - c);
+                    float *both = info.GetCosts(n - 1 - r, n - 1 - c);
+
+                    for (unsigned int o = 0; o < orientations; ++o) {
+
+                        // the opposite orientation
+                        unsigned int opposite = (orientations - o) % orientations;
+
+                        reflected[opposite] = cost[o];
+                        flipped[opposite] = cost[o];
+                        both[o] = cost[o];
+
+                    }
+
+                }
+
+            }
+
+        }
+
+    public:
+
+        // compute the non-holonomic without obstacles heuristic around a given neihgborhood
+        // only a quarter of the table is computed, the rows are split among the threads (zero means all the cores)
+        // each finished row is saved to the checkpoint file, an interrupted run resumes from it
+        // the payload is the heuristic_info.bin format, the returned table is always the full float32 one
+        static astar::NonholonomicHeuristicInfo* Calculate(
+                double neighborhoodSize,
+                double resolution,
+                int orientations,
+                double vehicle_turn_radius,
+                unsigned int num_threads = 0,
+                std::string checkpoint_filename = "heuristic_info.checkpoint",
+                astar::NonholonomicHeuristicPayload payload = astar::Float32Payload) {
+
             // creates a new heuristic info
             astar::NonholonomicHeuristicInfo *info = new astar::NonholonomicHeuristicInfo;
 
@@ -66,6 +416,9 @@ class HeuristicCalculator {
             // save the resolution
             info->resolution = resolution;
 
+            // save the turn radius, it's in the binary file header
+            info->turn_radius = vehicle_turn_radius;
+
             // how many cells??
             info->num_cells = std::ceil(neighborhoodSize / resolution);
 
@@ -83,57 +436,136 @@ class HeuristicCalculator {
             info->max_heuristic_value = std::numeric_limits<double>::min();
 
             // allocate the heuristic table
-            info->heuristic = new double**[info->num_cells];
+            info->Build();
 
-            for (unsigned int r = 0; r < info->num_cells; ++r) {
+            // the quadrant rows, from the center row to the last one
+            unsigned int half = info->num_cells / 2;
+            std::vector<char> done(info->num_cells - half, 0);
 
-                info->heuristic[r] = new double*[info->num_cells];
+            // recover the rows of an interrupted run
+            unsigned int recovered = LoadCheckpoint(checkpoint_filename, *info, vehicle_turn_radius, done);
 
-                for (unsigned int c = 0; c < info->num_cells; ++c) {
+            if (0 < recovered) {
 
-                    info->heuristic[r][c] = new double[info->orientations];
+                std::cout << "Resuming from " << checkpoint_filename << ": " << recovered << " of " << done.size() << " rows\n";
+
+            }
+
+            // the rows to compute
+            std::vector<unsigned int> pending;
+
+            for (unsigned int k = 0; k < done.size(); ++k) {
+
+                if (0 == done[k]) {
+
+                    pending.push_back(half + k);
 
                 }
 
             }
 
-            // temp pose
-            astar::Pose2D pose;
+            // rewrite the checkpoint with the recovered rows only, a truncated record is dropped
+            std::ofstream checkpoint;
 
-            // the goal pose at the origin
-            astar::Pose2D goal(0.0, 0.0, 0.0);
+            if (0 < checkpoint_filename.size()) {
 
-            // compute the heuristic
-            for (unsigned int r = 0; r < info->num_cells; ++r) {
+                checkpoint.open(checkpoint_filename, std::ios::binary | std::ios::trunc);
 
-                for (unsigned int c = 0; c < info->num_cells; ++c) {
+                CheckpointHeader header(GetCheckpointHeader(*info, vehicle_turn_radius));
 
-                    double *cost = info->heuristic[r][c];
+                checkpoint.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
-                    for (unsigned int o = 0; o < info->orientations; ++o) {
+                for (unsigned int k = 0; k < done.size(); ++k) {
 
-                        // get the pose values
-                        pose.position.x = c * resolution - info->position_offset;
-                        pose.position.y = r * resolution - info->position_offset;
-                        pose.orientation = o * info->orientation_offset;
+                    if (0 != done[k]) {
 
-                        // Reeds-Shepp heuristic computation
-                        astar::ReedsSheppActionSetPtr action_set = rs.Solve(pose, goal, vehicle_turn_radius);
+                        WriteCheckpointRow(checkpoint, *info, half + k);
 
-                        if (0 < action_set->actions.size()) {
+                    }
 
-                            cost[o] = action_set->CalculateCost(vehicle_turn_radius, 1.0, 0.0);
+                }
 
-                            if (info->max_heuristic_value < cost[o]) {
+                checkpoint.flush();
 
-                                info->max_heuristic_value = cost[o];
+            }
 
-                            }
+            // how many threads
+            if (0 == num_threads) {
 
-                        }
+                num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+            }
+
+            // the shared row counter and the checkpoint lock
+            std::atomic<unsigned int> next(0);
+            std::mutex checkpoint_mutex;
+
+            std::vector<std::thread> workers;
+
+            for (unsigned int i = 1; i < num_threads; ++i) {
+
+                workers.push_back(std::thread(&HeuristicCalculator::CalculateRows, std::ref(*info), vehicle_turn_radius, std::cref(pending), std::ref(next), std::ref(checkpoint_mutex), std::ref(checkpoint)));
+
+            }
+
+            // the current thread works too
+            CalculateRows(*info, vehicle_turn_radius, pending, next, checkpoint_mutex, checkpoint);
+
+            for (unsigned int i = 0; i < workers.size(); ++i) {
+
+                workers[i].join();
+
+            }
+
+            // fill the whole table
+            MirrorQuadrant(*info);
+
+            // the interpolation bounds, after the whole table
+            // they are not in the checkpoint, it's a single pass over the quadrant
+            float *bounds = info->BuildInterpolationBounds();
+
+            pending.clear();
+
+            for (unsigned int r = half; r < info->num_cells; ++r) {
+
+                pending.push_back(r);
+
+            }
 
-                        // remove the action set
-                        delete action_set;
+            next = 0;
+
+            workers.clear();
+
+            for (unsigned int i = 1; i < num_threads; ++i) {
+
+                workers.push_back(std::thread(&HeuristicCalculator::CalculateBoundRows, std::ref(*info), vehicle_turn_radius, bounds, std::cref(pending), std::ref(next)));
+
+            }
+
+            CalculateBoundRows(*info, vehicle_turn_radius, bounds, pending, next);
+
+            for (unsigned int i = 0; i < workers.size(); ++i) {
+
+                workers[i].join();
+
+            }
+
+            DilateBounds(*info, bounds);
+
+            // the max heuristic value
+            for (unsigned int r = 0; r < info->num_cells; ++r) {
+
+                for (unsigned int c = 0; c < info->num_cells; ++c) {
+
+                    const float *cost = info->GetCosts(r, c);
+
+                    for (unsigned int o = 0; o < info->orientations; ++o) {
+
+                        if (std::numeric_limits<float>::infinity() != cost[o] && info->max_heuristic_value < cost[o]) {
+
+                            info->max_heuristic_value = cost[o];
+
+                        }
 
                     }
 
@@ -142,7 +574,16 @@ class HeuristicCalculator {
             }
 
             // save the current heuristic to the external file
-            NonholonomicHeuristicInfo::Save(*info, "heuristic_info.txt");
+            NonholonomicHeuristicInfo::Save(*info, "heuristic_info.bin", payload);
+
+            // the table is complete, the checkpoint is not needed anymore
+            if (checkpoint.is_open()) {
+
+                checkpoint.close();
+
+                std::remove(checkpoint_filename.c_str());
+
+            }
 
             return info;
 
@@ -11,6 +11,7 @@ HolonomicHeuristic::HolonomicHeuristic(InternalGridMapRef map) :
     goal(),
     twopi(2.0*M_PI),
     circle_path(),
+    circle_index(),
     nearest_open(),
     largest_open(),
     closed()
@@ -38,68 +39,35 @@ bool HolonomicHeuristic::Overlap(const astar::Circle &a, const astar::Circle &b,
 // get the nearest circle from a given pose
 HolonomicHeuristic::CircleNodePtr HolonomicHeuristic::NearestCircleNode(const astar::Pose2D &p) {
 
-    // stupid search
-    if (0 < circle_path.circles.size()) {
+    if (0 < circle_index.Size()) {
 
         // get a direct access
         std::vector<HolonomicHeuristic::CircleNodePtr> &circles(circle_path.circles);
 
         // the Vector2D access
-        Vector2D<double> position(p.position);
-
-        // iterators
-        std::vector<HolonomicHeuristic::CircleNodePtr>::iterator it = circles.begin();
-
-        // set the first circle as the closer one
-        std::vector<HolonomicHeuristic::CircleNodePtr>::iterator nearest = it;
-
-        // get the end iterator
-        std::vector<HolonomicHeuristic::CircleNodePtr>::iterator end = circles.end();
-        std::vector<HolonomicHeuristic::CircleNodePtr>::iterator next;
-
-        // get the current distance between the pose and the first circle
-        double distance = position.Distance((*it)->circle.position);
+        const Vector2D<double> &position(p.position);
 
-        // update the current iterator
-        ++it;
-
-        // iterate along the circle path
-        while (it != end) {
-
-            double d = position.Distance((*it)->circle.position);
-
-            if (d < distance) {
-
-                // update the values
-                distance = d;
-                nearest = it;
-
-            }
-
-            // update the iterator
-            ++it;
-
-        }
+        // the grid hash lookup, the same circle a linear search along the path would find
+        unsigned int nearest = circle_index.Nearest(position);
 
         // we got it!
-        next = nearest;
-        ++next;
+        unsigned int next = nearest + 1;
 
-        if (next != end){
+        if (next < circles.size()) {
 
             // get the position vectors reference
-            astar::Vector2D<double> &next_circle((*next)->circle.position);
-            astar::Vector2D<double> &current_circle((*nearest)->circle.position);
+            astar::Vector2D<double> &next_circle(circles[next]->circle.position);
+            astar::Vector2D<double> &current_circle(circles[nearest]->circle.position);
 
             if (current_circle.Distance2(next_circle) > position.Distance2(next_circle)) {
 
-                return *next;
+                return circles[next];
 
             }
 
         }
 
-        return *nearest;
+        return circles[nearest];
 
     }
 
@@ -453,6 +421,23 @@ void HolonomicHeuristic::ShowCirclePath() {
 
 }
 
+// index the current circle path centers
+void HolonomicHeuristic::BuildCirclePathIndex() {
+
+    // the circle centers, in the path order
+    std::vector<Vector2D<double>> centers;
+    centers.reserve(circle_path.circles.size());
+
+    for (unsigned int i = 0; i < circle_path.circles.size(); ++i) {
+
+        centers.push_back(circle_path.circles[i]->circle.position);
+
+    }
+
+    circle_index.Build(centers);
+
+}
+
 // the current search method
 bool HolonomicHeuristic::SpaceExploration() {
 
@@ -559,6 +544,9 @@ void HolonomicHeuristic::UpdateHeuristic(
 
         }
 
+        // the nearest circle queries use the index, an empty path gives an empty index
+        BuildCirclePathIndex();
+
     }
 
 }
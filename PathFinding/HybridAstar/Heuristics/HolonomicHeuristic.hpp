@@ -35,6 +35,7 @@
 #include "../../../Entities/Pose2D.hpp"
 #include "../../../Entities/Circle.hpp"
 #include "../../../PriorityQueue/PriorityQueue.hpp"
+#include "CirclePathIndex.hpp"
 
 namespace astar {
 
@@ -185,6 +186,9 @@ class HolonomicHeuristic {
         // the resulting circle path
         CircleNodePtrArray circle_path;
 
+        // the circle path centers index, for the nearest circle queries
+        astar::CirclePathIndex circle_index;
+
         // the nearest open queue
         std::priority_queue<CircleNodePtr, std::vector<CircleNodePtr>, CircleNodePtrDistanceComparator> nearest_open;
 
@@ -226,6 +230,9 @@ class HolonomicHeuristic {
         // show
         void ShowCirclePath();
 
+        // index the current circle path centers
+        void BuildCirclePathIndex();
+
 
     public:
 
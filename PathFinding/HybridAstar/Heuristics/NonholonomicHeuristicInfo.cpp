@@ -5,12 +5,25 @@
 #include <fstream>
 #include <cmath>
 #include <iostream>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace astar;
 
+// the class constants
+const uint32_t NonholonomicHeuristicInfo::Version;
+const uint16_t NonholonomicHeuristicInfo::QuantizedInfinity;
+
 // default constructor
 NonholonomicHeuristicInfo::NonholonomicHeuristicInfo() :
-		        neighborhood_size(0), num_cells(0), resolution(0.0), position_offset(0), orientations(0), orientation_offset(0), heuristic(nullptr), max_heuristic_value(std::numeric_limits<double>::max()) {}
+                storage(), mapping(nullptr), mapping_size(0), half_values(nullptr), quadrant_values(nullptr), quantization_step(0.0),
+                bound_storage(), interpolation_bounds(nullptr),
+                neighborhood_size(0), num_cells(0), resolution(0.0), position_offset(0), orientations(0), orientation_offset(0),
+                turn_radius(0.0), max_heuristic_value(std::numeric_limits<double>::max()), error_bound(0.0), heuristic(nullptr) {}
 
 // default destructor
 NonholonomicHeuristicInfo::~NonholonomicHeuristicInfo() {
@@ -28,72 +41,348 @@ void NonholonomicHeuristicInfo::Build() {
         // clear any old heuristic table
         Clear();
 
-        // allocate
-        heuristic = new double**[num_cells];
+        // allocate a single flat block
+        storage.resize(static_cast<std::size_t>(num_cells) * num_cells * orientations);
+
+        heuristic = &storage[0];
+
+        // the values are stored as they are computed
+        error_bound = 0.0;
+
+    }
+
+}
+
+// clear the entire heuristic table
+void NonholonomicHeuristicInfo::Clear() {
+
+    // release the memory
+    std::vector<float>().swap(storage);
+    std::vector<float>().swap(bound_storage);
+
+    if (nullptr != mapping) {
+
+        // unmap the external file
+        munmap(mapping, mapping_size);
+
+        mapping = nullptr;
+        mapping_size = 0;
 
-        for (unsigned int r = 0; r < num_cells; ++r) {
+    }
+
+    heuristic = nullptr;
+    half_values = nullptr;
+    quadrant_values = nullptr;
+    interpolation_bounds = nullptr;
+
+}
+
+// the payload checksum, 64 bits FNV-1a over 8 bytes words
+// the whole word step keeps the check cheap, the load time is mostly the checksum
+uint64_t NonholonomicHeuristicInfo::Checksum(const void *data, std::size_t size, uint64_t seed) {
+
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+
+    uint64_t hash = seed;
+
+    std::size_t i = 0;
 
-            heuristic[r] = new double*[num_cells];
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
 
-            for (unsigned int c = 0; c < num_cells; ++c) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+
+        hash ^= word;
+        hash *= 1099511628211ull;
+
+    }
+
+    // the remaining bytes
+    for (; i < size; ++i) {
+
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+
+    }
 
-                heuristic[r][c] = new double[orientations];
+    return hash;
+
+}
+
+// allocate the interpolation bounds of a table built in memory
+float* NonholonomicHeuristicInfo::BuildInterpolationBounds() {
+
+    std::size_t quadrant_cells = num_cells - num_cells / 2;
+
+    bound_storage.assign(quadrant_cells * quadrant_cells, 0.0f);
+
+    interpolation_bounds = &bound_storage[0];
+
+    return &bound_storage[0];
+
+}
+
+// the interpolated value inside a cell, without the bound
+double NonholonomicHeuristicInfo::Interpolate(unsigned int r, unsigned int c, unsigned int o, double dr, double dc, double dt) const {
+
+    // the next orientation wraps around
+    unsigned int next_o = orientations - 1 > o ? o + 1 : 0;
+
+    if (num_cells <= r + 1 || num_cells <= c + 1) {
+
+        // a border cell, the smallest of the available corners
+        double value = std::numeric_limits<double>::infinity();
+
+        for (unsigned int i = r; i <= std::min(r + 1, num_cells - 1); ++i) {
+
+            for (unsigned int j = c; j <= std::min(c + 1, num_cells - 1); ++j) {
+
+                value = std::min(value, std::min(GetValue(i, j, o), GetValue(i, j, next_o)));
 
             }
 
         }
 
+        return value;
+
     }
 
+    // interpolate along the orientation at the four corners
+    double c00 = GetValue(r, c, o) + (GetValue(r, c, next_o) - GetValue(r, c, o)) * dt;
+    double c01 = GetValue(r, c + 1, o) + (GetValue(r, c + 1, next_o) - GetValue(r, c + 1, o)) * dt;
+    double c10 = GetValue(r + 1, c, o) + (GetValue(r + 1, c, next_o) - GetValue(r + 1, c, o)) * dt;
+    double c11 = GetValue(r + 1, c + 1, o) + (GetValue(r + 1, c + 1, next_o) - GetValue(r + 1, c + 1, o)) * dt;
+
+    // then along the columns and the rows
+    double c0 = c00 + (c01 - c00) * dc;
+    double c1 = c10 + (c11 - c10) * dc;
+
+    return c0 + (c1 - c0) * dr;
+
 }
 
-// clear the entire heuristic table
-void NonholonomicHeuristicInfo::Clear() {
+// get the interpolated value at a given position and orientation, relative to the goal
+bool NonholonomicHeuristicInfo::GetInterpolatedValue(double x, double y, double orientation, double &value) const {
 
-    if (nullptr != heuristic && 0 != num_cells && 0 != orientations) {
+    if (nullptr == interpolation_bounds) {
 
-        for (unsigned int r = 0; r < num_cells; ++r) {
-            for (unsigned int c = 0; c < num_cells; ++c) {
+        return false;
 
-                // remove the orientation collumn
-                delete [] heuristic[r][c];
-            }
+    }
+
+    // move the pose to the first quadrant, the reflection and the time flip keep the cost
+    if (0.0 > y) {
+
+        y = -y;
+        orientation = -orientation;
+
+    }
+
+    if (0.0 > x) {
+
+        x = -x;
+        orientation = -orientation;
+
+    }
+
+    // the continuous table coordinates
+    double fr = (y + position_offset) / resolution;
+    double fc = (x + position_offset) / resolution;
+    double fo = orientation / orientation_offset;
+
+    // the same range as the nearest lookup, the poses past the last cell center take the border cells
+    if (num_cells - 0.5 <= fr || num_cells - 0.5 <= fc) {
+
+        return false;
+
+    }
+
+    // wrap the orientation to [0, orientations)
+    fo -= std::floor(fo / orientations) * orientations;
+
+    unsigned int half = num_cells / 2;
+
+    // the lower corner, the rounding may put a zero coordinate just below the center cell
+    unsigned int r = std::max(static_cast<unsigned int>(std::max(fr, 0.0)), half);
+    unsigned int c = std::max(static_cast<unsigned int>(std::max(fc, 0.0)), half);
+    unsigned int o = static_cast<unsigned int>(fo);
+
+    if (orientations <= o) {
+
+        o = 0;
+        fo = 0.0;
+
+    }
+
+    // the interpolation weights
+    double dr = std::max(fr - r, 0.0);
+    double dc = std::max(fc - c, 0.0);
+
+    // the cell bound is subtracted
+    value = std::max(Interpolate(r, c, o, dr, dc, fo - o) - interpolation_bounds[(r - half) * (num_cells - half) + c - half], 0.0);
+
+    return true;
+
+}
+
+// the payload size in bytes
+std::size_t NonholonomicHeuristicInfo::PayloadSize(NonholonomicHeuristicPayload payload, unsigned int num_cells, unsigned int orientations) {
+
+    if (QuantizedQuadrantPayload == payload) {
+
+        // the rows and columns at or past the center cell
+        std::size_t quadrant_cells = num_cells - num_cells / 2;
+
+        return quadrant_cells * quadrant_cells * orientations * sizeof(uint16_t);
+
+    }
+
+    std::size_t size = static_cast<std::size_t>(num_cells) * num_cells * orientations;
+
+    return size * (Float16Payload == payload ? sizeof(uint16_t) : sizeof(float));
+
+}
+
+// convert a cost to float32, rounding down
+float NonholonomicHeuristicInfo::ToFloat(double cost) {
+
+    if (std::numeric_limits<double>::max() <= cost) {
+
+        // there's no path
+        return std::numeric_limits<float>::infinity();
+
+    }
+
+    if (std::numeric_limits<float>::max() <= cost) {
+
+        return std::numeric_limits<float>::max();
+
+    }
+
+    float value = static_cast<float>(cost);
+
+    if (value > cost) {
+
+        // the closest float is above the cost
+        value = std::nextafter(value, -std::numeric_limits<float>::infinity());
+
+    }
+
+    return value;
+
+}
+
+// convert a cost to float16, rounding down
+uint16_t NonholonomicHeuristicInfo::ToHalf(double cost) {
+
+    // the float32 value is already rounded down, the mantissa truncation keeps it that way
+    float value = ToFloat(cost);
+
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    int exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    if (0xff == ((bits >> 23) & 0xffu)) {
+
+        // infinity and NaN
+        return sign | 0x7c00u | (0 != mantissa ? 0x200u : 0);
+
+    }
+
+    if (31 <= exponent) {
+
+        // the largest float16 value
+        return sign | 0x7bffu;
+
+    }
+
+    if (0 >= exponent) {
+
+        if (-10 > exponent) {
+
+            // too small, signed zero
+            return sign;
 
-            delete [] heuristic[r];
         }
 
-        delete [] heuristic;
+        // a subnormal value
+        return sign | static_cast<uint16_t>((mantissa | 0x800000u) >> (14 - exponent));
+
     }
 
+    return sign | static_cast<uint16_t>(exponent << 10) | static_cast<uint16_t>(mantissa >> 13);
+
 }
 
-// save the current heuristic to external file
-void NonholonomicHeuristicInfo::Save(const NonholonomicHeuristicInfo &info, std::string filename) {
+// save the current heuristic to the binary external file
+void NonholonomicHeuristicInfo::Save(const NonholonomicHeuristicInfo &info, std::string filename, NonholonomicHeuristicPayload payload) {
 
     if (nullptr != info.heuristic && 0 != info.num_cells && 0 != info.orientations && 0 < filename.size()) {
 
-        // open the external file
-        std::ofstream file(filename);
+        // how many values
+        std::size_t size = static_cast<std::size_t>(info.num_cells) * info.num_cells * info.orientations;
+
+        // the 16 bits payloads, if needed
+        std::vector<uint16_t> values;
+
+        // the quantization step, the largest finite cost takes the last finite step
+        double step = 0.0;
+
+        if (Float16Payload == payload) {
+
+            values.resize(size);
+
+            for (std::size_t i = 0; i < size; ++i) {
+
+                values[i] = ToHalf(info.heuristic[i]);
+
+            }
+
+        } else if (QuantizedQuadrantPayload == payload) {
 
-        // save the neighborhood size int the first line
-        file << info.neighborhood_size << std::endl;
+            unsigned int half = info.num_cells / 2;
 
-        // save the resolution in the second line
-        file << info.resolution << std::endl;
+            step = std::max(info.max_heuristic_value, 0.0) / (QuantizedInfinity - 1);
 
-        // save the orientations in the third line
-        file << info.orientations << std::endl;
+            if (0.0 >= step) {
 
-        // write the current heuristic table to output file
-        for (unsigned int r = 0; r < info.num_cells; ++r) {
+                step = 1.0;
 
-            for (unsigned int c = 0; c < info.num_cells; ++c) {
+            }
+
+            values.reserve(PayloadSize(payload, info.num_cells, info.orientations) / sizeof(uint16_t));
+
+            for (unsigned int r = half; r < info.num_cells; ++r) {
+
+                // the quadrant columns are contiguous
+                const float *cost = info.heuristic + (static_cast<std::size_t>(r) * info.num_cells + half) * info.orientations;
+                const float *end = cost + static_cast<std::size_t>(info.num_cells - half) * info.orientations;
+
+                for (; cost < end; ++cost) {
+
+                    if (std::numeric_limits<float>::infinity() == *cost) {
+
+                        values.push_back(QuantizedInfinity);
+
+                        continue;
 
-                double *cost = info.heuristic[r][c];
+                    }
 
-                for (unsigned int o = 0; o < info.orientations; ++o) {
+                    // round down, the product must not be above the cost either
+                    double q = std::floor(std::max(static_cast<double>(*cost), 0.0) / step);
 
-                    file << cost[o] << " ";
+                    q = std::min(q, static_cast<double>(QuantizedInfinity - 1));
+
+                    if (0.0 < q && q * step > *cost) {
+
+                        q -= 1.0;
+
+                    }
+
+                    values.push_back(static_cast<uint16_t>(q));
 
                 }
 
@@ -101,7 +390,46 @@ void NonholonomicHeuristicInfo::Save(const NonholonomicHeuristicInfo &info, std:
 
         }
 
-        file << std::endl;
+        // the payload bytes
+        const void *data = Float32Payload != payload ? static_cast<const void*>(&values[0]) : static_cast<const void*>(info.heuristic);
+        std::size_t data_size = PayloadSize(payload, info.num_cells, info.orientations);
+
+        // build the header
+        NonholonomicHeuristicHeader header;
+        std::memset(&header, 0, sizeof(header));
+
+        header.tag[0] = 'N';
+        header.tag[1] = 'H';
+        header.tag[2] = 'H';
+        header.tag[3] = 'T';
+        header.version = Version;
+        header.payload = payload;
+        header.payload_size = data_size;
+        header.num_cells = info.num_cells;
+        header.orientations = info.orientations;
+        header.neighborhood_size = info.neighborhood_size;
+        header.resolution = info.resolution;
+        header.turn_radius = info.turn_radius;
+        header.max_heuristic_value = info.max_heuristic_value;
+        header.quantization_step = step;
+        header.bound_cells = nullptr != info.interpolation_bounds ? (info.num_cells - info.num_cells / 2) * (info.num_cells - info.num_cells / 2) : 0;
+        header.checksum = Checksum(info.interpolation_bounds, header.bound_cells * sizeof(float), Checksum(data, data_size));
+
+        // open the external file
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(data), data_size);
+
+        if (0 < header.bound_cells) {
+
+            // the bounds are aligned
+            const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+            file.write(padding, BoundsOffset(data_size) - data_size);
+            file.write(reinterpret_cast<const char*>(info.interpolation_bounds), header.bound_cells * sizeof(float));
+
+        }
 
         // close the file
         file.close();
@@ -115,13 +443,11 @@ void NonholonomicHeuristicInfo::Load(NonholonomicHeuristicInfo &info, std::strin
 
     if (0 < filename.size()) {
 
-        std::string line;
-
         // open the external file
-        std::ifstream file(filename);
+        int fd = open(filename.c_str(), O_RDONLY);
 
         // verify if the file is open
-        if (!file.is_open()) {
+        if (0 > fd) {
 
             //
             std::cout << "Could no open the file: " << filename << "\n";
@@ -131,63 +457,214 @@ void NonholonomicHeuristicInfo::Load(NonholonomicHeuristicInfo &info, std::strin
 
         }
 
-        // clear the old heuristic table, if any
-        info.Clear();
+        // get the file size
+        struct stat file_stat;
 
-        // get the neighborhood size in the first line
-        file >> info.neighborhood_size;
+        if (0 != fstat(fd, &file_stat)) {
 
-        // get the resolution in the second line
-        file >> info.resolution;
+            close(fd);
 
-        // get the orientations in the third line
-        file >> info.orientations;
+            std::cout << "Could no read the file: " << filename << "\n";
 
-        // compute the number of cells
-        // get the orientations offsets
-        info.orientation_offset = 2.0 * M_PI / info.orientations;
+            throw std::exception();
+
+        }
+
+        std::size_t file_size = file_stat.st_size;
+
+        // the binary files start with the tag
+        char tag[4] = { 0, 0, 0, 0 };
+
+        if (static_cast<ssize_t>(sizeof(tag)) != pread(fd, tag, sizeof(tag), 0) || 0 != std::memcmp(tag, "NHHT", sizeof(tag))) {
+
+            close(fd);
+
+            // it's the old text format
+            LoadText(info, filename);
+
+            return;
+
+        }
+
+        // map the entire file, the values are used in place
+        void *mapping = sizeof(NonholonomicHeuristicHeader) <= file_size ? mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+
+        // the mapping keeps the file
+        close(fd);
+
+        if (MAP_FAILED == mapping) {
+
+            std::cout << "Could no map the file: " << filename << "\n";
+
+            throw std::exception();
+
+        }
 
-        // how many cells??
-        info.num_cells = std::ceil(info.neighborhood_size / info.resolution);
+        // the file header
+        const NonholonomicHeuristicHeader &header(*static_cast<const NonholonomicHeuristicHeader*>(mapping));
 
-        // get odd number of cells
-        if (0 == info.num_cells % 2) {
+        // the payload
+        const char *data = static_cast<const char*>(mapping) + sizeof(NonholonomicHeuristicHeader);
 
-            info.num_cells += 1;
+        // the payload type
+        NonholonomicHeuristicPayload payload = static_cast<NonholonomicHeuristicPayload>(header.payload);
+
+        // the expected payload size
+        std::size_t data_size = PayloadSize(payload, header.num_cells, header.orientations);
+
+        // the interpolation bounds
+        std::size_t quadrant_cells = header.num_cells - header.num_cells / 2;
+        std::size_t bounds_size = header.bound_cells * sizeof(float);
+        const float *bounds = reinterpret_cast<const float*>(data + BoundsOffset(data_size));
+
+        if (Version != header.version || (Float32Payload != payload && Float16Payload != payload && QuantizedQuadrantPayload != payload) ||
+                header.payload_size != data_size || (0 != header.bound_cells && quadrant_cells * quadrant_cells != header.bound_cells) ||
+                file_size < sizeof(header) + (0 < bounds_size ? BoundsOffset(data_size) + bounds_size : data_size) ||
+                header.checksum != Checksum(bounds, bounds_size, Checksum(data, data_size))) {
+
+            munmap(mapping, file_size);
+
+            std::cout << "Invalid heuristic file: " << filename << "\n";
+
+            throw std::exception();
 
         }
 
+        // clear the old heuristic table, if any
+        info.Clear();
+
+        // the table parameters
+        info.neighborhood_size = header.neighborhood_size;
+        info.resolution = header.resolution;
+        info.orientations = header.orientations;
+        info.num_cells = header.num_cells;
+        info.turn_radius = header.turn_radius;
+        info.max_heuristic_value = header.max_heuristic_value;
+
+        // get the orientations offsets
+        info.orientation_offset = 2.0 * M_PI / info.orientations;
+
         // compute the offset
         info.position_offset = std::floor(info.num_cells * 0.5) * info.resolution;
 
-        // the max heuristic value
-        info.max_heuristic_value = std::numeric_limits<double>::min();
+        // the values are used in place
+        info.mapping = mapping;
+        info.mapping_size = file_size;
+
+        if (0 < header.bound_cells) {
 
-        // clear the heuristic
+            info.interpolation_bounds = bounds;
 
-        // allocate
-        info.Build();
+        }
 
-        // read the current heuristic table from the input file
-        for (unsigned int r = 0; r < info.num_cells; ++r) {
+        if (Float16Payload == payload) {
 
-            for (unsigned int c = 0; c < info.num_cells; ++c) {
+            info.half_values = reinterpret_cast<const uint16_t*>(data);
 
-                double *cost = info.heuristic[r][c];
+            // the float16 spacing at the largest value
+            info.error_bound = std::ldexp(1.0, std::ilogb(std::max(info.max_heuristic_value, 1.0)) - 10);
 
-                for (unsigned int o = 0; o < info.orientations; ++o) {
+        } else if (QuantizedQuadrantPayload == payload) {
 
-                    file >> cost[o];
+            info.quadrant_values = reinterpret_cast<const uint16_t*>(data);
+            info.quantization_step = header.quantization_step;
 
-                }
+            // a value is at most one step below the float32 value it was quantized from
+            info.error_bound = header.quantization_step + std::ldexp(1.0, std::ilogb(std::max(info.max_heuristic_value, 1.0)) - 23);
 
-            }
+        } else {
+
+            info.heuristic = reinterpret_cast<const float*>(data);
+
+            // the float32 spacing at the largest value
+            info.error_bound = std::ldexp(1.0, std::ilogb(std::max(info.max_heuristic_value, 1.0)) - 23);
 
         }
 
-        // close the file
-        file.close();
+        // the old in memory table used doubles for every cell
+        double full_size = static_cast<double>(info.num_cells) * info.num_cells * info.orientations * sizeof(double);
+
+        std::cout << "Heuristic table " << filename << ": " << data_size / 1048576.0 << " MB, "
+                << (full_size - data_size) / 1048576.0 << " MB saved over the full double table, error bound: " << info.error_bound << "\n";
 
     }
 
 }
+
+// load the old text format
+void NonholonomicHeuristicInfo::LoadText(NonholonomicHeuristicInfo &info, std::string filename) {
+
+    // open the external file
+    std::ifstream file(filename);
+
+    // verify if the file is open
+    if (!file.is_open()) {
+
+        //
+        std::cout << "Could no open the file: " << filename << "\n";
+
+        // just a standard exception
+        throw std::exception();
+
+    }
+
+    // clear the old heuristic table, if any
+    info.Clear();
+
+    // get the neighborhood size in the first line
+    file >> info.neighborhood_size;
+
+    // get the resolution in the second line
+    file >> info.resolution;
+
+    // get the orientations in the third line
+    file >> info.orientations;
+
+    // compute the number of cells
+    // get the orientations offsets
+    info.orientation_offset = 2.0 * M_PI / info.orientations;
+
+    // how many cells??
+    info.num_cells = std::ceil(info.neighborhood_size / info.resolution);
+
+    // get odd number of cells
+    if (0 == info.num_cells % 2) {
+
+        info.num_cells += 1;
+
+    }
+
+    // compute the offset
+    info.position_offset = std::floor(info.num_cells * 0.5) * info.resolution;
+
+    // the max heuristic value
+    info.max_heuristic_value = std::numeric_limits<double>::min();
+
+    // allocate
+    info.Build();
+
+    // read the current heuristic table from the input file
+    for (unsigned int r = 0; r < info.num_cells; ++r) {
+
+        for (unsigned int c = 0; c < info.num_cells; ++c) {
+
+            float *cost = info.GetCosts(r, c);
+
+            for (unsigned int o = 0; o < info.orientations; ++o) {
+
+                double value;
+
+                file >> value;
+
+                cost[o] = ToFloat(value);
+
+            }
+
+        }
+
+    }
+
+    // close the file
+    file.close();
+
+}
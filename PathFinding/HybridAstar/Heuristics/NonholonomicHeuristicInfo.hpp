@@ -26,11 +26,142 @@
 #define HYBRID_ASTAR_NON_HOLOMIC_HEURISTIC_INFO_HPP
 
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 namespace astar {
 
+// the binary heuristic file payload types
+// the quantized quadrant payload keeps only the rows and columns at or past the center cell, as 16 bits steps
+// the other quadrants are the reflection (x, -y, -t) and the time flip (-x, y, -t) of the stored one
+enum NonholonomicHeuristicPayload { Float32Payload, Float16Payload, QuantizedQuadrantPayload };
+
+// the binary heuristic file header, the payload comes right after it
+// the values are in the row, column and orientation order
+// the interpolation bounds, if any, come after the payload at the next 8 bytes boundary
+class NonholonomicHeuristicHeader {
+
+    public:
+
+        // the file tag and the format version
+        char tag[4];
+        uint32_t version;
+
+        // the payload type
+        uint32_t payload;
+
+        // the table dimensions
+        uint32_t num_cells;
+        uint32_t orientations;
+
+        // how many interpolation bounds, zero if there's none
+        uint32_t bound_cells;
+
+        // the payload size in bytes
+        uint64_t payload_size;
+
+        // the table parameters
+        double neighborhood_size;
+        double resolution;
+        double turn_radius;
+        double max_heuristic_value;
+
+        // the quantized payload step, a stored value q means q times the step
+        double quantization_step;
+
+        // the payload and interpolation bounds checksum, 64 bits FNV-1a over 8 bytes words
+        uint64_t checksum;
+
+};
+
 class NonholonomicHeuristicInfo {
 
+    private:
+
+        // the table values, when they are not mapped from a file
+        std::vector<float> storage;
+
+        // the mapped file, if any
+        void *mapping;
+        std::size_t mapping_size;
+
+        // the float16 values inside the mapped file, if any
+        const uint16_t *half_values;
+
+        // the quantized quadrant values inside the mapped file, if any
+        const uint16_t *quadrant_values;
+
+        // the quantized quadrant step
+        double quantization_step;
+
+        // the interpolation bounds, when they are not mapped from a file
+        std::vector<float> bound_storage;
+
+        // the amount subtracted from the interpolated value, for each quadrant cell: the largest sampled excess over the
+        // Reeds-Shepp cost around the cell plus a safety margin, see HeuristicCalculator
+        // null if there's no bound, the interpolation is not available then
+        const float *interpolation_bounds;
+
+        // the binary file format version
+        static const uint32_t Version = 4;
+
+        // the quantized value of a path that doesn't exist
+        static const uint16_t QuantizedInfinity = 0xffff;
+
+        // the payload checksum, the seed chains a previous checksum
+        static uint64_t Checksum(const void*, std::size_t, uint64_t seed = 14695981039346656037ull);
+
+        // the payload size in bytes
+        static std::size_t PayloadSize(NonholonomicHeuristicPayload, unsigned int num_cells, unsigned int orientations);
+
+        // the interpolation bounds offset from the payload start, the next 8 bytes boundary
+        static std::size_t BoundsOffset(std::size_t payload_size) { return (payload_size + 7) & ~static_cast<std::size_t>(7); }
+
+        // get a value from the quantized quadrant
+        double GetQuadrantValue(unsigned int row, unsigned int col, unsigned int o) const {
+
+            unsigned int half = num_cells / 2;
+
+            // the mirrored cells are taken from the stored quadrant
+            if (half > row || half > col) {
+
+                // the reflection and the time flip use the opposite orientation, both at once keep it
+                if ((half > row) != (half > col) && 0 != o) {
+
+                    o = orientations - o;
+
+                }
+
+                if (half > row) {
+
+                    row = num_cells - 1 - row;
+
+                }
+
+                if (half > col) {
+
+                    col = num_cells - 1 - col;
+
+                }
+
+            }
+
+            uint16_t q = quadrant_values[(static_cast<std::size_t>(row - half) * (num_cells - half) + col - half) * orientations + o];
+
+            return QuantizedInfinity != q ? q * quantization_step : std::numeric_limits<double>::infinity();
+
+        }
+
+        // load the old text format
+        static void LoadText(NonholonomicHeuristicInfo&, std::string);
+
+        // the table must not be shared, it may be a file mapping
+        NonholonomicHeuristicInfo(const NonholonomicHeuristicInfo&);
+        void operator=(const NonholonomicHeuristicInfo&);
+
     public:
 
         // default parameters
@@ -40,9 +171,16 @@ class NonholonomicHeuristicInfo {
         double position_offset;
         unsigned int orientations;
         double orientation_offset;
-        double ***heuristic;
+        double turn_radius;
         double max_heuristic_value;
 
+        // the largest difference between a table value and the computed cost, the table values are never above the cost
+        double error_bound;
+
+        // the flat float32 table, in the row, column and orientation order
+        // null when the table is a float16 or a quantized quadrant mapping, see GetValue
+        const float *heuristic;
+
         // default constructor
         NonholonomicHeuristicInfo();
 
@@ -55,10 +193,102 @@ class NonholonomicHeuristicInfo {
         // clear the entire table
         void Clear();
 
-        // save the current heuristic to external file
-        static void Save(const NonholonomicHeuristicInfo&, std::string);
+        // allocate the interpolation bounds of a table built in memory, one value for each quadrant cell
+        // the quadrant cell (r, c) has the corners (half + r, half + c) and (half + r + 1, half + c + 1)
+        // the last row and column cells are the half cells before the table border
+        float* BuildInterpolationBounds();
+
+        // tells if the table has the interpolation bounds
+        bool HasInterpolationBounds() const { return nullptr != interpolation_bounds; }
+
+        // the interpolated value inside the cell (r, c, o) without the bound, dr, dc and dt are the weights inside the cell
+        // the trilinear interpolation, the cells in the last row or column take the smallest of their corners
+        double Interpolate(unsigned int r, unsigned int c, unsigned int o, double dr, double dc, double dt) const;
+
+        // the orientation costs of a given cell, only for a table built in memory
+        float* GetCosts(unsigned int row, unsigned int col) {
+
+            return &storage[(row * num_cells + col) * orientations];
+
+        }
+
+        // get a table value
+        double GetValue(unsigned int row, unsigned int col, unsigned int o) const {
+
+            if (nullptr != quadrant_values) {
+
+                return GetQuadrantValue(row, col, o);
+
+            }
+
+            std::size_t i = (static_cast<std::size_t>(row) * num_cells + col) * orientations + o;
+
+            return nullptr != heuristic ? heuristic[i] : HalfToFloat(half_values[i]);
+
+        }
+
+        // get the interpolated value at a given position and orientation, relative to the goal
+        // the orientation wraps around and the cell bound is subtracted, it's conservative within the verified margin,
+        // not a proven lower bound of the Reeds-Shepp cost
+        // returns false outside the nearest lookup range or without the interpolation bounds
+        bool GetInterpolatedValue(double x, double y, double orientation, double &value) const;
+
+        // convert a cost to float32, rounding down so the heuristic is not overestimated
+        static float ToFloat(double);
+
+        // convert a cost to float16, rounding down so the heuristic is not overestimated
+        static uint16_t ToHalf(double);
+
+        // convert a float16 value to float32
+        static float HalfToFloat(uint16_t half) {
+
+            uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+            uint32_t exponent = (half >> 10) & 0x1fu;
+            uint32_t mantissa = half & 0x3ffu;
+            uint32_t bits;
+
+            if (0x1fu == exponent) {
+
+                // infinity and NaN
+                bits = sign | 0x7f800000u | (mantissa << 13);
+
+            } else if (0 != exponent) {
+
+                // a normal value, rebias the exponent
+                bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+            } else if (0 != mantissa) {
+
+                // a subnormal value, normalize it
+                exponent = 113;
+
+                while (0 == (mantissa & 0x400u)) {
+
+                    mantissa <<= 1;
+                    --exponent;
+
+                }
+
+                bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+
+            } else {
+
+                // signed zero
+                bits = sign;
+
+            }
+
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            return value;
+
+        }
+
+        // save the current heuristic to the binary external file
+        static void Save(const NonholonomicHeuristicInfo&, std::string, NonholonomicHeuristicPayload payload = Float32Payload);
 
-        // load the external heuristic file
+        // load the external heuristic file, the binary files are mapped and the old text files are parsed
         static void Load(NonholonomicHeuristicInfo&, std::string);
 };
 
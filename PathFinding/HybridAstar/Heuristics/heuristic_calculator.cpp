@@ -1,13 +1,41 @@
+// g++ -std=c++11 -O2 -pthread heuristic_calculator.cpp NonholonomicHeuristicInfo.cpp ../../../ReedsShepp/ReedsSheppModel.cpp ../../../ReedsShepp/ReedsSheppActionSet.cpp ../../../Entities/Pose2D.cpp ../../../Entities/State2D.cpp
+// ./a.out [threads] [float32|float16|quantized], writes heuristic_info.bin, an interrupted run resumes from heuristic_info.checkpoint
 #include <iostream>
+#include <cstdlib>
+#include <string>
 #include "HeuristicCalculator.hpp"
 
-int main ()  {
+int main (int argc, char **argv)  {
 
-	astar::HeuristicCalculator::Calculate(60, 0.2, 80, 5.08);
+	// zero means all the cores
+	unsigned int threads = 1 < argc ? std::atoi(argv[1]) : 0;
+
+	// the binary file payload
+	astar::NonholonomicHeuristicPayload payload = astar::Float32Payload;
+
+	if (2 < argc) {
+
+		std::string type(argv[2]);
+
+		if ("float16" == type) {
+
+			payload = astar::Float16Payload;
+
+		} else if ("quantized" == type) {
+
+			// a quarter of the table, 16 bits steps
+			payload = astar::QuantizedQuadrantPayload;
+
+		}
+
+	}
+
+	astar::NonholonomicHeuristicInfo *info = astar::HeuristicCalculator::Calculate(60, 0.2, 80, 5.08, threads, "heuristic_info.checkpoint", payload);
+
+	delete info;
 
 	std::cout << "\nDone!\n";
 
 	return 0;
 
 }
-
@@ -24,6 +24,11 @@
 
 #include "HybridAstar.hpp"
 
+#include <fstream>
+#include <limits>
+#include <chrono>
+#include <cstdint>
+
 #include <opencv2/opencv.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -41,10 +46,31 @@ HybridAstar::HybridAstar(
     grid(map),
     heuristic(map),
     open(nullptr),
-    discovered(),
-    invalid(),
+    nodes(),
+    closed(),
+    action_sets(),
+    action_set_memory(0),
+    children(),
     map(nullptr),
-    width(), height() {}
+    width(), height(),
+    expanded_nodes(0),
+    primitives(),
+    use_primitives(false),
+    lazy_collision(false),
+    collision_checks(0),
+    anytime_weight(1.0),
+    anytime_weight_step(0.5),
+    anytime_budget(0.0),
+    anytime_solutions(),
+    max_expanded_nodes(0),
+    max_node_memory(0),
+    max_search_time(0.0),
+    search_deadline(),
+    limit_checks(0),
+    search_status(NoPathFound),
+    partial_path(false),
+    closest_node(nullptr),
+    closest_h(std::numeric_limits<double>::infinity()) {}
 
 HybridAstar::~HybridAstar() {
 
@@ -56,42 +82,56 @@ HybridAstar::~HybridAstar() {
 // remove all nodes
 void HybridAstar::RemoveAllNodes() {
 
-    HybridAstarNodePtr tmp;
-
     // clear the open set
-    // since we put pointers inside the PriorityQueue, we should delete all by ourselfs
-    // luckilly, they are copied in the discovered and invalid list
+    // the nodes itself live inside the arena
     open.ClearHeap();
 
-    // clear the closed set
-    while(!discovered.empty()) {
+    // delete the Reeds-Shepp action sets
+    while(!action_sets.empty()) {
 
-        // get the last element
-        tmp = discovered.back();
+        // delete the last element
+        delete action_sets.back();
 
-        // remove the node from the set
-        discovered.pop_back();
-
-        // delete the node
-        delete tmp;
+        // remove the action set pointer
+        action_sets.pop_back();
 
     }
 
-    // clear the invalid set
-    while(!invalid.empty()) {
+    action_set_memory = 0;
+
+    // release all nodes at once
+    nodes.Reset();
+
+    return;
+
+}
+
+// record the open set operations, see the priority queue benchmark
+// s: new search, a <node> <key>: add, d <node> <key>: decrease key, p: delete min
+void HybridAstar::TraceOpenSet(char op, HybridAstarNodePtr node, double key) {
+
+#ifdef HYBRID_ASTAR_TRACE_OPEN_SET
+
+    // the trace file, appended across the searches
+    static std::ofstream trace("open_set_trace.txt", std::ofstream::app);
 
-        // get the last element
-        tmp = invalid.back();
+    trace << op;
 
-        // remove the node from the set
-        invalid.pop_back();
+    if ('a' == op || 'd' == op) {
 
-        // delete the node
-        delete tmp;
+        trace << " " << reinterpret_cast<std::uintptr_t>(node) << " " << key;
 
     }
 
-    return;
+    trace << "\n";
+
+#else
+
+    (void) op;
+    (void) node;
+    (void) key;
+
+#endif
 
 }
 
@@ -119,12 +159,12 @@ StateArrayPtr HybridAstar::RebuildPath(HybridAstarNodePtr n, const State2D &star
     while(nullptr != n) {
 
         // is there a single action?
-        if (nullptr != n->action) {
+        if (nullptr == n->action_set) {
 
             // update the current state
             // see operator=(Pose2D) overloading
             s = n->pose;
-            s.gear = n->action->gear;
+            s.gear = n->action.gear;
 
             // save the current state to the list
             states.push_front(s);
@@ -233,7 +273,7 @@ HybridAstarNodePtr HybridAstar::GetReedsSheppChild(const Pose2D &start, const Po
         // iterate over the state list
         for (std::vector<State2D>::iterator it = states.begin(); it != end; ++it) {
 
-            if (!grid.isValidPoint(it->position) || !grid.isSafePlace(vehicle.GetVehicleBodyCircles(*it), vehicle.safety_factor)) {
+            if (!grid.isValidPoint(it->position) || !grid.isSafePlace(*it, vehicle.footprint, vehicle.safety_factor)) {
 
                 // not a good state
                 safe = false;
@@ -249,8 +289,12 @@ HybridAstarNodePtr HybridAstar::GetReedsSheppChild(const Pose2D &start, const Po
 
         if (safe) {
 
+            // the action set lives until the end of the current search
+            action_sets.push_back(action_set);
+            action_set_memory += sizeof(ReedsSheppActionSet) + action_set->actions.capacity() * sizeof(ReedsSheppAction);
+
             // return the HybridAstarNode on the goal state
-            return new HybridAstarNode(goal, action_set);
+            return nodes.Allocate(goal, action_set);
 
         }
 
@@ -263,35 +307,226 @@ HybridAstarNodePtr HybridAstar::GetReedsSheppChild(const Pose2D &start, const Po
 
 }
 
+// how fast the farthest footprint circle moves along an arc, per unit of arc length
+double HybridAstar::ArcSpeed(Steer steer) {
+
+    if (RSStraight == steer) {
+
+        return 1.0;
+
+    }
+
+    // the rear axle moves along the arc and the circle rotates around it
+    double k = vehicle.footprint.reach / vehicle.min_turn_radius;
+
+    return std::sqrt(1.0 + k * k);
+
+}
+
+// verify the arc between a node and a child with the conservative advancement
+// no footprint circle can move farther than the current clearance before the next check,
+// so the whole arc is as safe as the checked poses, up to the same half cell rounding of the distance map
+bool HybridAstar::isSafeArc(const Pose2D &start, double clearance, Steer steer, Gear gear, double length) {
+
+    // the circle speed along the arc
+    double speed = ArcSpeed(steer);
+
+    // the smallest advancement, half a cell
+    double min_step = 0.5 * grid.GetResolution();
+
+    // the current arc length
+    double s = 0.0;
+
+    while (true) {
+
+        // move as far as the current clearance allows
+        s += std::max(min_step, clearance / speed);
+
+        if (s >= length) {
+
+            // the end pose was verified before
+            return true;
+
+        }
+
+        // the next pose along the arc
+        Pose2D pose(vehicle.NextPose(start, steer, gear, s, vehicle.min_turn_radius));
+
+        clearance = grid.GetClearance(pose.position, pose.orientation, vehicle.footprint, vehicle.safety_factor);
+
+        if (0.0 > clearance) {
+
+            return false;
+
+        }
+
+    }
+
+}
+
+// verify the end pose and the swept area of a given primitive
+bool HybridAstar::isSafePrimitive(const Pose2D &start, unsigned int bin, double clearance, const MotionPrimitiveTable::Primitive &p) {
+
+    // the end pose first, most of the unsafe moves end inside an obstacle
+    if (!grid.isSafePlace(primitives.Position(start, bin, p.end), start.orientation + p.end.angle, vehicle.footprint, vehicle.safety_factor, p.position_error)) {
+
+        return false;
+
+    }
+
+    // the circle speed along the arc
+    double speed = ArcSpeed(p.steer);
+
+    // the tabulated poses may be position_error away from the actual arc
+    clearance = std::max(0.0, clearance - p.position_error);
+
+    // the arc segments between the start and the end pose
+    unsigned int segments = p.swept.size() + 1;
+
+    // the conservative advancement over the tabulated poses, the start pose is the first one
+    for (unsigned int i = 0; ; ) {
+
+        // how many poses the current clearance covers, at least the next one
+        double covered = clearance / (speed * p.spacing);
+
+        i = covered < segments - i ? i + std::max(1u, static_cast<unsigned int>(covered)) : segments;
+
+        if (segments <= i) {
+
+            // the end pose was verified before
+            return true;
+
+        }
+
+        const MotionPrimitiveTable::Delta &d(p.swept[i - 1]);
+
+        // the footprint table wraps the orientation
+        clearance = grid.GetClearance(primitives.Position(start, bin, d), start.orientation + d.angle, vehicle.footprint, vehicle.safety_factor, p.position_error);
+
+        if (0.0 > clearance) {
+
+            return false;
+
+        }
+
+    }
+
+}
+
+// verify a child built without any collision check, the lazy collision checking
+bool HybridAstar::isSafeChild(HybridAstarNodePtr child) {
+
+    // one more verified child
+    collision_checks++;
+
+    // the parent pose
+    const Pose2D &start(child->parent->pose);
+
+    // the parent clearance, the first advancement along the arc
+    double clearance = std::max(0.0, grid.GetClearance(start.position, start.orientation, vehicle.footprint, vehicle.safety_factor));
+
+    // the child move
+    const ReedsSheppAction &action(child->action);
+
+    // the child pose itself, the parent pose may have been replaced after the child was built
+    // and then the move from the current parent pose ends somewhere else
+    if (!grid.isSafePlace(child->pose, vehicle.footprint, vehicle.safety_factor)) {
+
+        return false;
+
+    }
+
+    if (use_primitives) {
+
+        // the same primitive, see GetChidlren
+        const MotionPrimitiveTable::Primitive &p(primitives.Get(action.steer, action.gear, primitives.LengthClass(action.length)));
+
+        return isSafePrimitive(start, primitives.HeadingBin(start.orientation), clearance, p);
+
+    }
+
+    return isSafeArc(start, clearance, action.steer, action.gear, action.length);
+
+}
+
 // get the children nodes by expanding all gears and steering
-HybridAstarNodeArrayPtr HybridAstar::GetChidlren(const Pose2D &start, const Pose2D &goal, Gear gear, double length) {
+void HybridAstar::GetChidlren(const Pose2D &start, const Pose2D &goal, Gear gear, double length, std::vector<HybridAstarNodePtr> &children) {
+
+    // reuse the buffer
+    children.clear();
+
+    // the children poses, one for each steering move
+    Pose2D child_poses[astar::NumSteering];
+
+    // the primitive length class and the start heading bin, the same for all the primitives
+    unsigned int length_class = 0, bin = 0;
+
+    if (use_primitives) {
+
+        // the length is already a length class length, see FindPath
+        length_class = primitives.LengthClass(length);
+        bin = primitives.HeadingBin(start.orientation);
+
+        // the precomputed moves
+        for (unsigned int j = 0; j < astar::NumSteering; j++) {
+
+            child_poses[j] = primitives.EndPose(start, bin, primitives.Get(static_cast<Steer>(j), gear, length_class));
+
+        }
+
+    } else {
+
+        // get all the next states at once
+        vehicle.NextPoses(start, gear, length, vehicle.min_turn_radius, child_poses);
+
+    }
+
+    if (lazy_collision) {
+
+        // iterate over the steering moves
+        for (unsigned int j = 0; j < astar::NumSteering; j++) {
+
+            // only the grid boundary, the collision checks wait until the child leaves the open set
+            if (grid.isValidPoint(child_poses[j].position)) {
+
+                HybridAstarNodePtr child = nodes.Allocate(child_poses[j], ReedsSheppAction(static_cast<Steer>(j), gear, length));
+
+                // see isSafeChild
+                child->validated = false;
+
+                // append to the children list
+                children.push_back(child);
+
+            }
+
+        }
 
-    // build the vector
-    HybridAstarNodeArrayPtr children = new HybridAstarNodeArray();
+    } else {
 
-    // a reference syntactic sugar
-    std::vector<HybridAstarNodePtr> &nodes(children->nodes);
+        // the parent clearance, the first advancement along all the arcs
+        // an unsafe start pose advances by the smallest steps
+        double clearance = std::max(0.0, grid.GetClearance(start.position, start.orientation, vehicle.footprint, vehicle.safety_factor));
 
-    // a state helper, the current child
-    Pose2D child_pose;
+        // verify the end poses of all children at once, the primitives verify their own end poses
+        unsigned int safe = use_primitives ? ~0u : grid.CheckPoses(child_poses, astar::NumSteering, vehicle.footprint, vehicle.safety_factor);
 
-    // double turn_radius
-    double tr = vehicle.min_turn_radius;
+        // all the children are verified
+        collision_checks += astar::NumSteering;
 
-    // iterate over the steering moves
-    for (unsigned int j = 0; j < astar::NumSteering; j++) {
+        // iterate over the steering moves
+        for (unsigned int j = 0; j < astar::NumSteering; j++) {
 
-        // casting the steering
-        Steer steer = static_cast<Steer>(j);
+            // casting the steering
+            Steer steer = static_cast<Steer>(j);
 
-        // get the next state
-        child_pose = vehicle.NextPose(start, steer, gear, length, tr);
+            // verify the safety condition, the grid boundary and the arc between the parent and the child
+            if ((safe & (1u << j)) && grid.isValidPoint(child_poses[j].position) &&
+                (use_primitives ? isSafePrimitive(start, bin, clearance, primitives.Get(steer, gear, length_class)) : isSafeArc(start, clearance, steer, gear, length))) {
 
-        // verify the safety condition and the grid boundary
-        if (grid.isValidPoint(child_pose.position) && grid.isSafePlace(vehicle.GetVehicleBodyCircles(child_pose), vehicle.safety_factor)) {
+                // append to the children list
+                children.push_back(nodes.Allocate(child_poses[j], ReedsSheppAction(steer, gear, length)));
 
-            // append to the children list
-            nodes.push_back(new HybridAstarNode(child_pose, new ReedsSheppAction(steer, gear, length)));
+            }
 
         }
 
@@ -315,7 +550,7 @@ HybridAstarNodeArrayPtr HybridAstar::GetChidlren(const Pose2D &start, const Pose
             if (nullptr != rsNode) {
 
                 // append to the children list
-                nodes.push_back(rsNode);
+                children.push_back(rsNode);
 
             }
 
@@ -323,11 +558,163 @@ HybridAstarNodeArrayPtr HybridAstar::GetChidlren(const Pose2D &start, const Pose
 
     }
 
-    return children;
-
 }
 
 // PUBLIC METHODS
+// set the closed set angular resolution, the number of heading bins
+void HybridAstar::SetHeadingResolution(unsigned int headings) {
+
+    closed.SetHeadingResolution(headings);
+
+}
+
+// use the interpolated nonholonomic heuristic lookup
+void HybridAstar::SetInterpolatedHeuristic(bool flag) {
+
+    heuristic.SetInterpolation(flag);
+
+}
+
+// expand the nodes with the precomputed motion primitives
+void HybridAstar::SetMotionPrimitives(bool flag) {
+
+    use_primitives = flag;
+
+}
+
+// verify the children when they leave the open set instead of when they are built
+void HybridAstar::SetLazyCollisionChecking(bool flag) {
+
+    lazy_collision = flag;
+
+}
+
+// search with a decreasing heuristic weight and return the best path found within the wall clock budget
+// a weight not above one disables the anytime search, a non positive budget waits for the weight one path
+void HybridAstar::SetAnytimeSearch(double weight, double weight_step, double budget) {
+
+    anytime_weight = weight;
+
+    // the weight must decrease, otherwise the search would never reach the weight one
+    anytime_weight_step = 0.0 < weight_step ? weight_step : 0.5;
+
+    anytime_budget = budget;
+
+}
+
+// stop the search after the expanded nodes, the search memory in bytes or the wall clock time in seconds
+// the search memory is the nodes, the closed set entries and the Reeds-Shepp action sets, not the open set
+// a zero limit is not verified, the search returns the path to the node closest to the goal when it stops
+void HybridAstar::SetSearchLimits(unsigned int expansions, std::size_t memory, double time) {
+
+    max_expanded_nodes = expansions;
+    max_node_memory = memory;
+    max_search_time = time;
+
+}
+
+// get the number of nodes expanded by the last search
+unsigned int HybridAstar::GetExpandedNodes() const {
+
+    return expanded_nodes;
+
+}
+
+// get the number of children verified by the last search
+unsigned int HybridAstar::GetCollisionChecks() const {
+
+    return collision_checks;
+
+}
+
+// get the heuristic weight and the cost of each path found by the last anytime search
+const std::vector<std::pair<double, double>>& HybridAstar::GetAnytimeSolutions() const {
+
+    return anytime_solutions;
+
+}
+
+// get how the last search stopped
+SearchStatus HybridAstar::GetSearchStatus() const {
+
+    return search_status;
+
+}
+
+// the last path ends at the node closest to the goal instead of the goal
+bool HybridAstar::isPartialPath() const {
+
+    return partial_path;
+
+}
+
+// get the plain heuristic value of the node the last partial path ends at
+double HybridAstar::GetClosestHeuristic() const {
+
+    return closest_h;
+
+}
+
+// verify the search limits before each expansion and save the stop reason
+bool HybridAstar::SearchLimitReached() {
+
+    if (0 < max_expanded_nodes && max_expanded_nodes <= expanded_nodes) {
+
+        search_status = ExpansionLimitReached;
+
+        return true;
+
+    }
+
+    // the children of a single expansion may exceed the limit a little
+    if (0 < max_node_memory && max_node_memory <= nodes.Size() * sizeof(HybridAstarNode) + closed.MemoryUsage() + action_set_memory) {
+
+        search_status = MemoryLimitReached;
+
+        return true;
+
+    }
+
+    // reading the clock is not free
+    if (0.0 < max_search_time && 0 == (++limit_checks & 31) && search_deadline < std::chrono::steady_clock::now()) {
+
+        search_status = DeadlineReached;
+
+        return true;
+
+    }
+
+    return false;
+
+}
+
+// keep the expanded node closest to the goal
+void HybridAstar::UpdateClosestNode(HybridAstarNodePtr n, double h) {
+
+    if (h < closest_h) {
+
+        closest_node = n;
+        closest_h = h;
+
+    }
+
+}
+
+// rebuild the path to the node closest to the goal and clear all the nodes
+StateArrayPtr HybridAstar::PartialPath(const State2D &start, const State2D &goal) {
+
+    // the start node alone gives an empty path
+    StateArrayPtr path = nullptr != closest_node ? RebuildPath(closest_node, start, goal) : new StateArray();
+
+    partial_path = true;
+
+    // clear all opened and expanded nodes
+    RemoveAllNodes();
+
+    return path;
+
+}
+
 // receives the grid, start and goal states and find a path, if possible
 StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &start, const State2D &goal) {
 
@@ -350,11 +737,51 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
     // the start state heuristic value
     double heuristic_value = heuristic.GetHeuristicValue(start_pose, goal_pose);
 
-    // find the current cell
-    GridMapCellPtr c = grid_map.PoseToCell(start_pose);
+    // a new search, nothing expanded yet
+    expanded_nodes = 0;
+    collision_checks = 0;
+    anytime_solutions.clear();
+
+    // no limit reached yet
+    search_status = NoPathFound;
+    partial_path = false;
+    closest_node = nullptr;
+    closest_h = std::numeric_limits<double>::infinity();
+    limit_checks = 0;
 
-    // the goal cell
-    GridMapCellPtr gc = grid_map.PoseToCell(goal_pose);
+    if (0.0 < max_search_time) {
+
+        search_deadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(max_search_time));
+
+    }
+
+    // the shortest primitive is a single cell long, the swept poses are half a cell apart
+    double sample_step = 0.5 * resolution;
+
+    if (use_primitives && !primitives.Matches(resolution, vehicle.min_turn_radius, sample_step)) {
+
+        // the grid resolution or the vehicle has changed
+        primitives.Build(resolution, vehicle.min_turn_radius, sample_step);
+
+    }
+
+    // invalidate the previous search nodes
+    closed.NewSearch(grid_map.GetWidth(), grid_map.GetHeight());
+
+    // the current closed set key
+    std::size_t key;
+
+    // the goal key
+    std::size_t goal_key;
+
+    if (!closed.GetKey(grid_map.PoseToIndex(start_pose.position), start_pose.orientation, key) ||
+        !closed.GetKey(grid_map.PoseToIndex(goal_pose.position), goal_pose.orientation, goal_key)) {
+
+        // the start or the goal are outside the grid map
+        return new StateArray();
+
+    }
 
     // the available space around the vehicle
     // provides the total length between the current state and the node's children
@@ -366,16 +793,33 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
     // the simple case of dt
     // dt = grid_map.resolution/vehicle.default_speed
 
+    // the anytime search starts with an inflated heuristic
+    if (1.0 < anytime_weight) {
+
+        heuristic_value *= anytime_weight;
+
+    }
+
     // create a new Node
-    // the node updates the cell node pointer and the cell status
-    // see the HybridAstarNode constructor
-    HybridAstarNodePtr n = new HybridAstarNode(start_pose, new ReedsSheppAction(), c, length, heuristic_value, nullptr);
+    HybridAstarNodePtr n = nodes.Allocate(start_pose, ReedsSheppAction(), length, heuristic_value, nullptr);
 
     // push the start node to the queue
+    TraceOpenSet('s', nullptr, 0.0);
+    TraceOpenSet('a', n, heuristic_value);
     n->handle = open.Add(n, heuristic_value);
 
-    // push the start node to the discovered set
-    discovered.push_back(n);
+    // update the node status
+    n->status = OpenedNode;
+
+    // save the start node to the closed set
+    closed.Insert(key, n);
+
+    if (1.0 < anytime_weight) {
+
+        // the same start, a different main loop
+        return AnytimeSearch(start, goal, goal_pose, goal_key);
+
+    }
 
     // the cost from the start to the current position
     double tentative_g;
@@ -387,14 +831,41 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
     // the actual A* algorithm
     while(!open.isEmpty()) {
 
+        if (SearchLimitReached()) {
+
+            // the best effort
+            return PartialPath(start, goal);
+
+        }
+
+        TraceOpenSet('p', nullptr, 0.0);
         n = open.DeleteMin();
 
+        // the lazy collision checking, the node is verified only now
+        if (!n->validated) {
+
+            if (!isSafeChild(n)) {
+
+                // the node keeps its closed set slot, but any other child can take it
+                n->status = ExploredNode;
+                n->g = n->f = std::numeric_limits<double>::infinity();
+
+                continue;
+
+            }
+
+            n->validated = true;
+
+        }
+
         // is it the desired goal?
         if (goal_pose == n->pose) {
 
             // rebuild the entire path
             StateArrayPtr resulting_path = RebuildPath(n, start, goal);
 
+            search_status = PathFound;
+
             // clear all opened and expanded nodes
             RemoveAllNodes();
 
@@ -404,7 +875,13 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
         }
 
         // add to the explored set
-        n->cell->status = ExploredNode;
+        n->status = ExploredNode;
+
+        // one more expanded node
+        expanded_nodes++;
+
+        // the key keeps the heuristic value
+        UpdateClosestNode(n, n->f - n->g);
 
         // get the length based on the environment
         double obst = grid_map.GetObstacleDistance(n->pose.position);
@@ -412,6 +889,13 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
 
         length = std::max(resolution, 0.5 * (obst + voro_dist));
 
+        if (use_primitives) {
+
+            // the primitive lengths are discrete, a longer move is still safe, the whole arc is verified
+            length = primitives.Length(primitives.LengthClass(length));
+
+        }
+
         // iterate over the gears
         for (unsigned int i = 0; i < NumGears; i++) {
 
@@ -419,29 +903,24 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
             Gear gear = static_cast<Gear>(i);
 
             // get the children nodes by expanding all gears and steering
-            HybridAstarNodeArrayPtr children = GetChidlren(n->pose, goal_pose, gear, length);
+            GetChidlren(n->pose, goal_pose, gear, length, children);
 
-            // reference, just a syntactic sugar
-            std::vector<HybridAstarNodePtr> &nodes(children->nodes);
-            std::vector<HybridAstarNodePtr>::iterator end = nodes.end();
+            std::vector<HybridAstarNodePtr>::iterator end = children.end();
 
             // iterate over the current node's children
-            for (std::vector<HybridAstarNodePtr>::iterator it = nodes.begin(); it != end; ++it) {
+            for (std::vector<HybridAstarNodePtr>::iterator it = children.begin(); it != end; ++it) {
 
                 // avoid a lot of indirect access
                 HybridAstarNodePtr child = *it;
 
-                // find the appropriated location in the grid
-                // reusing the same "c" pointer declared above
-                c = grid_map.PoseToCell(child->pose);
-
-                // we must avoid node->cell = nullptr inside the HybridAstarNode
-                if (nullptr != c) {
+                // find the appropriated location in the closed set
+                // we must avoid children outside the grid map
+                if (closed.GetKey(grid_map.PoseToIndex(child->pose.position), child->pose.orientation, key)) {
 
-                    if (nullptr != child->action) {
+                    if (nullptr == child->action_set) {
 
                         // we a have a valid action, conventional expanding
-                        tentative_g = n->g + PathCost(n->action->gear, child->pose, gear, length);
+                        tentative_g = n->g + PathCost(n->action.gear, child->pose, gear, length);
 
                     } else if (0 < child->action_set->Size()) {
 
@@ -451,9 +930,7 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
                     } else {
 
                         // we don't have any valid action, it's a bad error
-                        // add to the invalid nodes set
-                        invalid.push_back(child);
-
+                        // the node is released with the arena
                         // jump to the next iteration
                         continue;
                         // throw std::exception();
@@ -461,7 +938,7 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
                     }
 
                     // update the heuristic contribution
-                    tentative_f = tentative_g + heuristic.GetHeuristicValue(child->pose, goal_pose);;
+                    tentative_f = tentative_g + heuristic.GetHeuristicValue(child->pose, goal_pose);
 
                     // update the cost
                     child->g = tentative_g;
@@ -472,43 +949,352 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
                     // set the parent
                     child->parent = n;
 
-                    // is it a not opened node?
-                    if (UnknownNode == c->status) {
+                    // the node already visited at the same position and heading
+                    HybridAstarNodePtr current = closed.Find(key);
 
-                        // set the cell pointer
-                        child->cell = c;
+                    // is it a not opened node?
+                    if (nullptr == current) {
 
-                        // update the cell pointer
-                        c->node = child;
+                        // update the node status
+                        child->status = OpenedNode;
 
-                        // update the cell status
-                        c->status = OpenedNode;
+                        // save the node to the closed set
+                        closed.Insert(key, child);
 
                         // add to the open set
+                        TraceOpenSet('a', child, tentative_f);
                         child->handle = open.Add(child, tentative_f);
 
-                    } else if (tentative_f < c->node->f) {
+                    } else if (tentative_f < current->f) {
 
-                        if ((c == gc && 0.1 > std::fabs(goal_pose.orientation - child->pose.orientation)) || c != gc) {
+                        if ((key == goal_key && 0.1 > std::fabs(goal_pose.orientation - child->pose.orientation)) || key != goal_key) {
 
-                            // update the node at the cell
-                            HybridAstarNodePtr current = c->node;
+                            // a verified node may have its own children, so it only takes a verified child
+                            if (current->validated && !child->validated) {
+
+                                if (!isSafeChild(child)) {
+
+                                    continue;
+
+                                }
+
+                                child->validated = true;
+
+                            }
 
                             // the old node is updated but not the corresponding Handle/Key in the priority queue
                             current->UpdateValues(*child);
 
-                            if (OpenedNode == c->status) {
+                            if (OpenedNode == current->status) {
+
+                                // decrease the key at the priority queue
+                                TraceOpenSet('d', current, tentative_f);
+                                open.DecreaseKey(current->handle, tentative_f);
+
+                            } else if (ExploredNode == current->status) {
+
+                                // the node was explored, let's revive it
+                                TraceOpenSet('a', current, tentative_f);
+                                current->handle = open.Add(current, tentative_f);
+
+                                // reset the node status
+                                current->status = OpenedNode;
+
+                            }
+
+                        }
+
+                    }
+
+                }
+
+            }
+
+        }
+
+    }
+
+    // the A* could no find a valid path to the goal
+    RemoveAllNodes();
+
+    return new StateArray();
+
+}
+
+// move the inconsistent nodes to the open set and update all the keys to a new heuristic weight
+void HybridAstar::ReweightOpenSet(std::vector<HybridAstarNodePtr> &inconsistent, double old_weight, double new_weight) {
+
+    // the lower weight may increase a key or decrease it below the last extracted one
+    // so the open set is drained and rebuilt, both changes are fine for any priority queue
+    while (!open.isEmpty()) {
+
+        TraceOpenSet('p', nullptr, 0.0);
+        inconsistent.push_back(open.DeleteMin());
+
+    }
+
+    TraceOpenSet('s', nullptr, 0.0);
+    open.ClearHeap();
+
+    std::vector<HybridAstarNodePtr>::iterator end = inconsistent.end();
+
+    for (std::vector<HybridAstarNodePtr>::iterator it = inconsistent.begin(); it != end; ++it) {
+
+        HybridAstarNodePtr n = *it;
+
+        // the key keeps the weighted heuristic value, there's no need to evaluate the heuristic again
+        n->f = n->g + new_weight * (n->f - n->g) / old_weight;
+
+        // update the node status
+        n->status = OpenedNode;
+
+        TraceOpenSet('a', n, n->f);
+        n->handle = open.Add(n, n->f);
+
+    }
+
+    inconsistent.clear();
+
+}
+
+// the anytime search, ARA* over the hybrid nodes
+// each iteration is a weighted A* that stops as soon as the open set can't improve the best path
+// the nodes improved after their expansion wait in the inconsistent list, the next iteration starts from
+// the same open and closed sets with a lower weight, so only the affected nodes are expanded again
+StateArrayPtr HybridAstar::AnytimeSearch(const State2D &start, const State2D &goal, const Pose2D &goal_pose, std::size_t goal_key) {
+
+    // the wall clock deadline
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(anytime_budget));
+
+    // a non positive budget means no deadline at all
+    bool has_deadline = 0.0 < anytime_budget;
+
+    // get the grid map resolution
+    double resolution = grid.GetResolution();
+
+    // the current heuristic weight
+    double weight = anytime_weight;
+
+    // the best path so far and its cost
+    StateArrayPtr best_path = nullptr;
+    double best_cost = std::numeric_limits<double>::infinity();
+
+    // the nodes expanded by the current iteration
+    std::vector<HybridAstarNodePtr> expanded;
+
+    // the nodes improved after their expansion by the current iteration
+    std::vector<HybridAstarNodePtr> inconsistent;
+
+    // the current closed set key
+    std::size_t key;
+
+    // how many nodes left the open set, the clock is read every 32 nodes
+    unsigned int popped = 0;
+
+    bool timeout = false;
+
+    while (!timeout) {
+
+        // improve the path with the current weight
+        while (!open.isEmpty()) {
+
+            if (has_deadline && 0 == (++popped & 31) && deadline < std::chrono::steady_clock::now()) {
+
+                search_status = DeadlineReached;
+                timeout = true;
+
+                break;
+
+            }
+
+            // the search limits stop all the iterations
+            if (SearchLimitReached()) {
+
+                timeout = true;
+
+                break;
+
+            }
+
+            // the remaining keys are not below the best path cost, the iteration ends here
+            if (best_cost <= open.Min()->f) {
+
+                break;
+
+            }
+
+            TraceOpenSet('p', nullptr, 0.0);
+            HybridAstarNodePtr n = open.DeleteMin();
+
+            // the lazy collision checking, the node is verified only now
+            if (!n->validated) {
+
+                if (!isSafeChild(n)) {
+
+                    // any other child can take the closed set slot and open it again
+                    n->status = UnknownNode;
+                    n->g = n->f = std::numeric_limits<double>::infinity();
+
+                    continue;
+
+                }
+
+                n->validated = true;
+
+            }
+
+            // add to the explored set
+            n->status = ExploredNode;
+            expanded.push_back(n);
+
+            // is it the desired goal?
+            if (n->pose == goal_pose) {
+
+                if (n->g < best_cost) {
+
+                    // the next iterations may change the node, so the path is rebuilt right now
+                    delete best_path;
+                    best_path = RebuildPath(n, start, goal);
+                    best_cost = n->g;
+
+                    anytime_solutions.push_back(std::make_pair(weight, best_cost));
+
+                }
+
+                // the goal is never expanded
+                continue;
+
+            }
+
+            // one more expanded node
+            expanded_nodes++;
+
+            // the key keeps the weighted heuristic value
+            UpdateClosestNode(n, (n->f - n->g) / weight);
+
+            // get the length based on the environment
+            double obst = grid.GetObstacleDistance(n->pose.position);
+            double voro_dist = grid.GetVoronoiDistance(n->pose.position);
+
+            double length = std::max(resolution, 0.5 * (obst + voro_dist));
+
+            if (use_primitives) {
+
+                // the primitive lengths are discrete, a longer move is still safe, the whole arc is verified
+                length = primitives.Length(primitives.LengthClass(length));
+
+            }
+
+            // iterate over the gears
+            for (unsigned int i = 0; i < NumGears; i++) {
+
+                // casting the gears
+                Gear gear = static_cast<Gear>(i);
+
+                // get the children nodes by expanding all gears and steering
+                GetChidlren(n->pose, goal_pose, gear, length, children);
+
+                std::vector<HybridAstarNodePtr>::iterator end = children.end();
+
+                // iterate over the current node's children
+                for (std::vector<HybridAstarNodePtr>::iterator it = children.begin(); it != end; ++it) {
+
+                    // avoid a lot of indirect access
+                    HybridAstarNodePtr child = *it;
+
+                    // we must avoid children outside the grid map
+                    if (!closed.GetKey(grid.PoseToIndex(child->pose.position), child->pose.orientation, key)) {
+
+                        continue;
+
+                    }
+
+                    // the cost from the start to the child
+                    double tentative_g;
+
+                    if (nullptr == child->action_set) {
+
+                        // we a have a valid action, conventional expanding
+                        tentative_g = n->g + PathCost(n->action.gear, child->pose, gear, length);
+
+                    } else if (0 < child->action_set->Size()) {
+
+                        // we have a valid action set, it was a Reeds-Shepp analytic expanding
+                        tentative_g = n->g + child->action_set->CalculateCost(vehicle.min_turn_radius, reverse_factor, gear_switch_cost);
+
+                    } else {
+
+                        // the node is released with the arena
+                        continue;
+
+                    }
+
+                    // the weighted key
+                    // the heuristic may overestimate, so a child is never pruned against the best path by its value
+                    double tentative_f = tentative_g + weight * heuristic.GetHeuristicValue(child->pose, goal_pose);
+
+                    child->g = tentative_g;
+                    child->f = tentative_f;
+                    child->parent = n;
+
+                    // the node already visited at the same position and heading
+                    HybridAstarNodePtr current = closed.Find(key);
+
+                    if (nullptr == current) {
+
+                        // update the node status
+                        child->status = OpenedNode;
+
+                        // save the node to the closed set
+                        closed.Insert(key, child);
+
+                        // add to the open set
+                        TraceOpenSet('a', child, tentative_f);
+                        child->handle = open.Add(child, tentative_f);
+
+                    } else if (tentative_g < current->g && tentative_f < current->f) {
+
+                        // the keys of the nodes expanded by a previous iteration keep the old weight, so only a cheaper
+                        // path replaces a visited node, otherwise a descendant could become the parent of its ancestor
+                        // the key must decrease too, the open set can't increase a key
+                        if ((key == goal_key && 0.1 > std::fabs(goal_pose.orientation - child->pose.orientation)) || key != goal_key) {
+
+                            // a verified node may have its own children, so it only takes a verified child
+                            if (current->validated && !child->validated) {
+
+                                if (!isSafeChild(child)) {
+
+                                    continue;
+
+                                }
+
+                                child->validated = true;
+
+                            }
+
+                            current->UpdateValues(*child);
+
+                            if (OpenedNode == current->status) {
 
                                 // decrease the key at the priority queue
+                                TraceOpenSet('d', current, tentative_f);
                                 open.DecreaseKey(current->handle, tentative_f);
 
-                            } else if (ExploredNode == c->status) {
+                            } else if (ExploredNode == current->status) {
 
-                                // the cell has an explored node, let's revive it
+                                // expanded by this iteration, it waits for the next weight
+                                current->status = InconsistentNode;
+                                inconsistent.push_back(current);
+
+                            } else if (UnknownNode == current->status) {
+
+                                // expanded by a previous iteration, or rejected by the lazy collision checking
+                                TraceOpenSet('a', current, tentative_f);
                                 current->handle = open.Add(current, tentative_f);
 
-                                // reset the cell status
-                                c->status = OpenedNode;
+                                // reset the node status
+                                current->status = OpenedNode;
 
                             }
 
@@ -518,21 +1304,69 @@ StateArrayPtr HybridAstar::FindPath(InternalGridMapRef grid_map, const State2D &
 
                 }
 
-                // add the node to the discovered set
-                discovered.push_back(child);
+            }
+
+        }
+
+        // the weight one iteration is the optimal search, and an empty open set without any path is a failure
+        if (timeout || 1.0 >= weight || nullptr == best_path) {
+
+            break;
+
+        }
+
+        // the next weight
+        double next_weight = std::max(1.0, weight - anytime_weight_step);
+
+        // the nodes expanded by this iteration may be expanded again by the next one
+        std::vector<HybridAstarNodePtr>::iterator end = expanded.end();
+
+        for (std::vector<HybridAstarNodePtr>::iterator it = expanded.begin(); it != end; ++it) {
+
+            if (ExploredNode == (*it)->status) {
+
+                (*it)->status = UnknownNode;
 
             }
 
-            // delete the children vector
-            delete children;
+        }
+
+        expanded.clear();
+
+        // the inconsistent nodes join the open set, all the keys use the new weight
+        ReweightOpenSet(inconsistent, weight, next_weight);
+
+        weight = next_weight;
+
+    }
+
+    if (nullptr != best_path) {
+
+        // the anytime budget or a search limit may stop the improvements, the path is still complete
+        if (!timeout) {
+
+            search_status = PathFound;
 
         }
 
+        // clear all opened and expanded nodes
+        RemoveAllNodes();
+
+        return best_path;
+
     }
 
-    // the A* could no find a valid path to the goal
+    if (timeout) {
+
+        // no path yet, the best effort
+        return PartialPath(start, goal);
+
+    }
+
+    // clear all opened and expanded nodes
     RemoveAllNodes();
 
+    // the empty open set, no path at all
     return new StateArray();
 
 }
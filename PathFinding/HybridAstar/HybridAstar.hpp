@@ -27,20 +27,29 @@
 
 #include <vector>
 #include <list>
+#include <chrono>
+#include <cstddef>
+#include <utility>
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
-#include "../../PriorityQueue/PriorityQueue.hpp"
 #include "../../Entities/Pose2D.hpp"
 #include "../../GridMap/InternalGridMap.hpp"
 #include "../../ReedsShepp/ReedsSheppModel.hpp"
 #include "../../VehicleModel/VehicleModel.hpp"
+#include "../../VehicleModel/MotionPrimitiveTable.hpp"
 #include "HybridAstarNode.hpp"
+#include "HybridAstarOpenSet.hpp"
+#include "HybridAstarNodeArena.hpp"
+#include "HybridAstarClosedSet.hpp"
 #include "Heuristics/Heuristic.hpp"
 
 namespace astar {
 
+// how the last search stopped, the limit status comes with the best partial path
+enum SearchStatus {PathFound, NoPathFound, ExpansionLimitReached, MemoryLimitReached, DeadlineReached};
+
 class HybridAstar {
 
     private:
@@ -69,31 +78,116 @@ class HybridAstar {
         astar::Heuristic heuristic;
 
         // the opened nodes set
-        astar::PriorityQueue<HybridAstarNodePtr> open;
+        astar::HybridAstarOpenSet open;
+
+        // the node storage, reset at the end of each search
+        astar::HybridAstarNodeArena nodes;
+
+        // the visited nodes, keyed by position and heading
+        astar::HybridAstarClosedSet closed;
 
-        // the expanded nodes set
-        std::vector<HybridAstarNodePtr> discovered;
+        // the Reeds-Shepp action sets used by the current search
+        std::vector<ReedsSheppActionSetPtr> action_sets;
 
-        // the invalid nodes set
-        std::vector<HybridAstarNodePtr> invalid;
+        // the memory held by the action sets, in bytes
+        std::size_t action_set_memory;
+
+        // the children nodes buffer, reused at each expansion
+        std::vector<HybridAstarNodePtr> children;
 
         // the current grid map
         unsigned char *map;
         unsigned width, height;
 
+        // how many nodes the last search expanded
+        unsigned int expanded_nodes;
+
+        // the precomputed expansions, built at the first search that uses them
+        astar::MotionPrimitiveTable primitives;
+
+        // expand the nodes with the primitive table instead of the vehicle model
+        bool use_primitives;
+
+        // verify the children only when they leave the open set
+        bool lazy_collision;
+
+        // how many children the last search verified
+        unsigned int collision_checks;
+
+        // the anytime search initial heuristic weight, the plain search when it is not above one
+        double anytime_weight;
+
+        // how much the heuristic weight decreases after each solution
+        double anytime_weight_step;
+
+        // the anytime search wall clock budget, in seconds
+        double anytime_budget;
+
+        // the heuristic weight and the cost of each path the last anytime search found, in order
+        std::vector<std::pair<double, double>> anytime_solutions;
+
+        // the search limits, zero means no limit
+        // the memory limit counts the nodes, the closed set entries and the Reeds-Shepp action sets
+        unsigned int max_expanded_nodes;
+        std::size_t max_node_memory;
+        double max_search_time;
+
+        // the last search wall clock deadline
+        std::chrono::steady_clock::time_point search_deadline;
+
+        // how many times the last search verified the limits, the clock is read every 32 checks
+        unsigned int limit_checks;
+
+        // how the last search stopped
+        astar::SearchStatus search_status;
+
+        // is the last path a partial path?
+        bool partial_path;
+
+        // the expanded node closest to the goal, by the plain heuristic value
+        HybridAstarNodePtr closest_node;
+        double closest_h;
+
         // PRIVATE METHODS
 
         // clear all the sets
         void RemoveAllNodes();
 
+        // record the open set operations when HYBRID_ASTAR_TRACE_OPEN_SET is defined
+        void TraceOpenSet(char, HybridAstarNodePtr, double);
+
         // reconstruct the path from the goal to the start pose
         astar::StateArrayPtr RebuildPath(HybridAstarNodePtr, const State2D&, const State2D&);
 
         // get the Reeds-Shepp path to the goal and return the appropriated HybridAstarNode
         HybridAstarNodePtr GetReedsSheppChild(const astar::Pose2D&, const astar::Pose2D&);
 
+        // how fast the farthest footprint circle moves along an arc, per unit of arc length
+        double ArcSpeed(astar::Steer);
+
+        // verify the end pose and the swept area of a given primitive
+        bool isSafePrimitive(const astar::Pose2D&, unsigned int, double, const astar::MotionPrimitiveTable::Primitive&);
+
+        // verify a child built without any collision check, the lazy collision checking
+        bool isSafeChild(HybridAstarNodePtr);
+
+        // verify the search limits before each expansion and save the stop reason
+        bool SearchLimitReached();
+
+        // keep the expanded node closest to the goal
+        void UpdateClosestNode(HybridAstarNodePtr, double);
+
+        // rebuild the path to the node closest to the goal and clear all the nodes
+        astar::StateArrayPtr PartialPath(const astar::State2D&, const astar::State2D&);
+
         // get the children nodes by expanding all gears and steering
-        HybridAstarNodeArrayPtr GetChidlren(const astar::Pose2D&, const astar::Pose2D&, astar::Gear, double);
+        void GetChidlren(const astar::Pose2D&, const astar::Pose2D&, astar::Gear, double, std::vector<HybridAstarNodePtr>&);
+
+        // move the inconsistent nodes to the open set and update all the keys to a new heuristic weight
+        void ReweightOpenSet(std::vector<HybridAstarNodePtr>&, double, double);
+
+        // the anytime search, a weighted A* that improves the path while the heuristic weight decreases
+        astar::StateArrayPtr AnytimeSearch(const astar::State2D&, const astar::State2D&, const astar::Pose2D&, std::size_t);
 
         // get the path cost
         double PathCost(
@@ -114,6 +208,47 @@ class HybridAstar {
         // basic destructor
         ~HybridAstar();
 
+        // set the closed set angular resolution, the number of heading bins
+        void SetHeadingResolution(unsigned int);
+
+        // use the interpolated nonholonomic heuristic lookup
+        void SetInterpolatedHeuristic(bool);
+
+        // expand the nodes with the precomputed motion primitives
+        void SetMotionPrimitives(bool);
+
+        // verify the children when they leave the open set instead of when they are built
+        void SetLazyCollisionChecking(bool);
+
+        // search with a decreasing heuristic weight and return the best path found within the wall clock budget
+        void SetAnytimeSearch(double, double, double);
+
+        // stop the search after the expanded nodes, the search memory in bytes or the wall clock time in seconds
+        // the search memory is the nodes, the closed set entries and the Reeds-Shepp action sets, not the open set
+        void SetSearchLimits(unsigned int, std::size_t, double);
+
+        // get the number of nodes expanded by the last search
+        unsigned int GetExpandedNodes() const;
+
+        // get the number of children verified by the last search
+        unsigned int GetCollisionChecks() const;
+
+        // get the heuristic weight and the cost of each path found by the last anytime search
+        const std::vector<std::pair<double, double>>& GetAnytimeSolutions() const;
+
+        // get how the last search stopped
+        astar::SearchStatus GetSearchStatus() const;
+
+        // the last path ends at the node closest to the goal instead of the goal
+        bool isPartialPath() const;
+
+        // get the plain heuristic value of the node the last partial path ends at
+        double GetClosestHeuristic() const;
+
+        // verify the arc between a node and a child with the conservative advancement, the end pose is already verified
+        // the start clearance is the first advancement, see InternalGridMap::GetClearance
+        bool isSafeArc(const astar::Pose2D&, double, astar::Steer, astar::Gear, double);
+
         // find a path to the goal
         astar::StateArrayPtr FindPath(astar::InternalGridMapRef, const astar::State2D&, const astar::State2D&);
 
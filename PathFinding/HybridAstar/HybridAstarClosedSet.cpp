@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cmath>
+
+#include "HybridAstarClosedSet.hpp"
+#include "../../Helpers/wrap2pi.hpp"
+
+using namespace astar;
+
+// the initial hash table size, must be a power of two
+#define CLOSED_SET_INITIAL_BITS 12
+
+// basic constructor
+HybridAstarClosedSet::HybridAstarClosedSet(unsigned int headings) :
+    table(1 << CLOSED_SET_INITIAL_BITS),
+    mask((1 << CLOSED_SET_INITIAL_BITS) - 1),
+    shift(64 - CLOSED_SET_INITIAL_BITS),
+    size(0),
+    generation(1),
+    width(0),
+    height(0),
+    num_headings(0),
+    heading_factor(0.0)
+{
+    // set the heading bins
+    SetHeadingResolution(headings);
+}
+
+// find the slot of a given key
+std::size_t HybridAstarClosedSet::FindSlot(std::size_t key) const {
+
+    // fibonacci hashing
+    std::size_t slot = (static_cast<unsigned long long>(key) * 11400714819323198485ull) >> shift;
+
+    // linear probing, there's no removal inside a generation
+    // so any entry from an old generation is an empty slot
+    while (generation == table[slot].generation && key != table[slot].key) {
+
+        slot = (slot + 1) & mask;
+
+    }
+
+    return slot;
+
+}
+
+// double the hash table size, keeping the entries from the current generation
+void HybridAstarClosedSet::Grow() {
+
+    // get the old table
+    std::vector<Entry> old;
+    old.swap(table);
+
+    // the new table
+    table.resize(old.size() << 1);
+    mask = table.size() - 1;
+    shift -= 1;
+
+    // reinsert the current entries
+    for (std::vector<Entry>::iterator it = old.begin(); it != old.end(); ++it) {
+
+        if (generation == it->generation) {
+
+            table[FindSlot(it->key)] = *it;
+
+        }
+
+    }
+
+}
+
+// set the angular resolution, the number of heading bins in [0, 2PI)
+void HybridAstarClosedSet::SetHeadingResolution(unsigned int headings) {
+
+    // at least one heading bin, the old 2D behavior
+    num_headings = 0 < headings ? headings : 1;
+
+    // the bins per radian
+    heading_factor = num_headings / (2.0 * M_PI);
+
+    // the keys have changed
+    NewSearch(width, height);
+
+}
+
+// get the number of heading bins
+unsigned int HybridAstarClosedSet::GetHeadingResolution() const {
+
+    return num_headings;
+
+}
+
+// start a new search over a grid map with the given dimensions
+void HybridAstarClosedSet::NewSearch(unsigned int w, unsigned int h) {
+
+    // the grid dimensions
+    width = w;
+    height = h;
+
+    // invalidate all the entries
+    generation += 1;
+    size = 0;
+
+    // the stamp wrapped around, the entries written 2^32 searches ago would look valid again
+    // it's the only case where the whole table must be cleared
+    if (0 == generation) {
+
+        std::fill(table.begin(), table.end(), Entry());
+
+        // the empty entries have the generation zero
+        generation = 1;
+
+    }
+
+}
+
+// get the key of a given cell index and orientation, returns false if the cell is outside the grid map
+bool HybridAstarClosedSet::GetKey(const GridCellIndex &index, double orientation, std::size_t &key) const {
+
+    if (height > index.row && width > index.col) {
+
+        // get the heading bin
+        unsigned int bin = static_cast<unsigned int>(mrpt::math::wrapTo2Pi<double>(orientation) * heading_factor + 0.5) % num_headings;
+
+        // the 3D key
+        key = (static_cast<std::size_t>(index.row) * width + index.col) * num_headings + bin;
+
+        return true;
+
+    }
+
+    return false;
+
+}
+
+// find the node stored at a given key, nullptr if the key was not visited in the current search
+HybridAstarNodePtr HybridAstarClosedSet::Find(std::size_t key) const {
+
+    // get the entry
+    const Entry &entry(table[FindSlot(key)]);
+
+    return generation == entry.generation ? entry.node : nullptr;
+
+}
+
+// store the node at a given key
+void HybridAstarClosedSet::Insert(std::size_t key, HybridAstarNodePtr n) {
+
+    // get the entry
+    Entry &entry(table[FindSlot(key)]);
+
+    if (generation != entry.generation) {
+
+        // a new entry
+        entry.key = key;
+        entry.generation = generation;
+
+        // update the counter
+        size += 1;
+
+    }
+
+    // save the node
+    entry.node = n;
+
+    // keep the load factor below 0.5
+    if ((size << 1) > table.size()) {
+
+        Grow();
+
+    }
+
+}
+
+// how many keys were visited in the current search
+std::size_t HybridAstarClosedSet::Size() const {
+
+    return size;
+
+}
+
+// the table memory the current search needs, in bytes
+std::size_t HybridAstarClosedSet::MemoryUsage() const {
+
+    // the load factor is kept below 0.5
+    return (size << 1) * sizeof(Entry);
+
+}
@@ -0,0 +1,108 @@
+#ifndef HYBRID_ASTAR_CLOSED_SET_HPP
+#define HYBRID_ASTAR_CLOSED_SET_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "HybridAstarNode.fwd.hpp"
+#include "../../GridMap/GridCellIndex.hpp"
+
+namespace astar {
+
+// the visited nodes table, keyed by (row, col, heading bin)
+// it's an open addressing hash table, so the memory grows with the number of visited nodes and not with the map size
+// each entry has a generation stamp: a new search invalidates all the old entries in constant time
+class HybridAstarClosedSet {
+
+    private:
+
+        // a single table entry
+        class Entry {
+
+            public:
+
+                // the (row, col, heading bin) key
+                std::size_t key;
+
+                // the search generation in which the entry was written
+                unsigned int generation;
+
+                // the node stored in the entry
+                astar::HybridAstarNodePtr node;
+
+                // basic constructor
+                Entry() : key(0), generation(0), node(nullptr) {}
+
+        };
+
+        // PRIVATE ATTRIBUTES
+
+        // the hash table
+        std::vector<Entry> table;
+
+        // the hash table size minus one, the table size is always a power of two
+        std::size_t mask;
+
+        // the hash shift
+        unsigned int shift;
+
+        // how many valid entries in the current generation
+        std::size_t size;
+
+        // the current generation
+        unsigned int generation;
+
+        // the grid map dimensions
+        unsigned int width, height;
+
+        // the number of heading bins
+        unsigned int num_headings;
+
+        // the heading bins per radian
+        double heading_factor;
+
+        // PRIVATE METHODS
+
+        // find the slot of a given key
+        std::size_t FindSlot(std::size_t) const;
+
+        // double the hash table size, keeping the entries from the current generation
+        void Grow();
+
+    public:
+
+        // PUBLIC METHODS
+
+        // basic constructor
+        HybridAstarClosedSet(unsigned int headings = 72);
+
+        // set the angular resolution, the number of heading bins in [0, 2PI)
+        void SetHeadingResolution(unsigned int headings);
+
+        // get the number of heading bins
+        unsigned int GetHeadingResolution() const;
+
+        // start a new search over a grid map with the given dimensions
+        void NewSearch(unsigned int w, unsigned int h);
+
+        // get the key of a given cell index and orientation, returns false if the cell is outside the grid map
+        bool GetKey(const astar::GridCellIndex&, double orientation, std::size_t &key) const;
+
+        // find the node stored at a given key, nullptr if the key was not visited in the current search
+        astar::HybridAstarNodePtr Find(std::size_t key) const;
+
+        // store the node at a given key
+        void Insert(std::size_t key, astar::HybridAstarNodePtr);
+
+        // how many keys were visited in the current search
+        std::size_t Size() const;
+
+        // the table memory the current search needs, in bytes: the visited keys at the largest load factor
+        // the table itself is kept across the searches, so its whole size is not a per search measure
+        std::size_t MemoryUsage() const;
+
+};
+
+}
+
+#endif
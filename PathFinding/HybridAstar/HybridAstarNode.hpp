@@ -2,14 +2,18 @@
 #define HYBRID_ASTAR_NODE_HPP
 
 #include <exception>
+#include <stdexcept>
 
 #include "../../Entities/Pose2D.hpp"
-#include "../../PriorityQueue/PriorityQueueNode.hpp"
+#include "HybridAstarOpenSet.hpp"
 #include "../../ReedsShepp/ReedsSheppActionSet.hpp"
-#include "../../GridMap/GridMapCell.fwd.hpp"
 
 namespace astar {
 
+// define the enumeration status
+// the anytime search keeps the nodes improved after their expansion as inconsistent until the next heuristic weight
+enum CellStatus {UnknownNode, OpenedNode, ExploredNode, InconsistentNode};
+
 class HybridAstarNode {
 
     private:
@@ -25,10 +29,11 @@ class HybridAstarNode {
         // the current pose
         astar::Pose2D pose;
 
-        // the steering action
-        astar::ReedsSheppActionPtr action;
+        // the steering action, stored inline
+        astar::ReedsSheppAction action;
 
-        // the steering action set
+        // the steering action set, a Reeds-Shepp analytic expansion when not null
+        // the node does not own the action set, see HybridAstar::action_sets
         astar::ReedsSheppActionSetPtr action_set;
 
         // the current node cost
@@ -40,23 +45,24 @@ class HybridAstarNode {
         // the parent node
         HybridAstarNode *parent;
 
-        // the current cell
-        astar::GridMapCellPtr cell;
+        // the node status inside the closed set
+        astar::CellStatus status;
+
+        // the footprint and the arc from the parent node were verified
+        // the lazy collision checking verifies the nodes only when they leave the open set
+        bool validated;
 
         // the priority queue handler
-        astar::PriorityQueueNodePtr<HybridAstarNode*> handle;
+        astar::HybridAstarOpenSet::Handle handle;
 
         // basic constructor with a given action
         HybridAstarNode(
-                const astar::Pose2D&, ReedsSheppActionPtr,
-                astar::GridMapCellPtr = nullptr, double cost_ = 0.0, double h_cost = 0.0, astar::HybridAstarNode *p = nullptr);
+                const astar::Pose2D&, const ReedsSheppAction&,
+                double cost_ = 0.0, double h_cost = 0.0, astar::HybridAstarNode *p = nullptr);
 
         // basic constructor
         HybridAstarNode(const astar::Pose2D&, ReedsSheppActionSetPtr,
-                astar::GridMapCellPtr = nullptr, double cost_ = 0.0, double h_cost = 0.0, astar::HybridAstarNode *p = nullptr);
-
-        // basic destructor
-        ~HybridAstarNode();
+                double cost_ = 0.0, double h_cost = 0.0, astar::HybridAstarNode *p = nullptr);
 
         // PUBLIC METHODS
 
@@ -94,20 +100,6 @@ class HyridAstarNodePtrComparator {
 
 };
 
-// a simple container
-class HybridAstarNodeArray {
-
-    public:
-
-        // PUBLIC ATTRIBUTES
-        // the pointers must be handled outside this class
-        std::vector<HybridAstarNodePtr> nodes;
-
-};
-
-// just another pointer syntactic sugar
-typedef HybridAstarNodeArray* HybridAstarNodeArrayPtr;
-
 }
 
 #endif
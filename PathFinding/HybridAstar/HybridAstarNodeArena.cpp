@@ -0,0 +1,72 @@
+#include "HybridAstarNodeArena.hpp"
+
+using namespace astar;
+
+// basic constructor
+HybridAstarNodeArena::HybridAstarNodeArena(std::size_t bsize) :
+    block_size(0 < bsize ? bsize : 1), blocks(), current_block(0), next_slot(0), num_nodes(0) {}
+
+// basic destructor
+HybridAstarNodeArena::~HybridAstarNodeArena() {
+
+    // release all the raw blocks
+    for (std::vector<HybridAstarNodePtr>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+
+        ::operator delete(static_cast<void*>(*it));
+
+    }
+
+}
+
+// get the next free slot, allocates a new block only when all the blocks are used
+void* HybridAstarNodeArena::NextSlot() {
+
+    // is the current block full?
+    if (block_size == next_slot) {
+
+        // move to the next block
+        current_block += 1;
+
+        // reset the slot index
+        next_slot = 0;
+
+    }
+
+    // do we need a new block?
+    if (blocks.size() == current_block) {
+
+        // get a raw block, the nodes are built in place
+        blocks.push_back(static_cast<HybridAstarNodePtr>(::operator new(block_size * sizeof(HybridAstarNode))));
+
+    }
+
+    // update the counter
+    num_nodes += 1;
+
+    return static_cast<void*>(blocks[current_block] + next_slot++);
+
+}
+
+// release all nodes in constant time, the memory blocks are kept for the next search
+void HybridAstarNodeArena::Reset() {
+
+    // rewind
+    current_block = 0;
+    next_slot = 0;
+    num_nodes = 0;
+
+}
+
+// how many nodes were built since the last reset
+std::size_t HybridAstarNodeArena::Size() const {
+
+    return num_nodes;
+
+}
+
+// the total memory reserved by the arena, in bytes
+std::size_t HybridAstarNodeArena::MemoryUsage() const {
+
+    return blocks.size() * block_size * sizeof(HybridAstarNode);
+
+}
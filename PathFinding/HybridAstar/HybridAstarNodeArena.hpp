@@ -0,0 +1,74 @@
+#ifndef HYBRID_ASTAR_NODE_ARENA_HPP
+#define HYBRID_ASTAR_NODE_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "HybridAstarNode.hpp"
+
+namespace astar {
+
+// a per search node storage
+// the nodes are built inside big raw blocks and released all at once by the Reset method
+// the HybridAstarNode destructor is never called, so the node must not own any resource
+class HybridAstarNodeArena {
+
+    private:
+
+        // PRIVATE ATTRIBUTES
+
+        // how many nodes inside each block
+        std::size_t block_size;
+
+        // the raw memory blocks
+        std::vector<HybridAstarNodePtr> blocks;
+
+        // the current block index
+        std::size_t current_block;
+
+        // the next free slot inside the current block
+        std::size_t next_slot;
+
+        // how many nodes were built since the last reset
+        std::size_t num_nodes;
+
+        // PRIVATE METHODS
+
+        // get the next free slot, allocates a new block only when all the blocks are used
+        void* NextSlot();
+
+    public:
+
+        // PUBLIC METHODS
+
+        // basic constructor
+        HybridAstarNodeArena(std::size_t bsize = 4096);
+
+        // basic destructor
+        ~HybridAstarNodeArena();
+
+        // build a new node inside the arena, same arguments as the HybridAstarNode constructors
+        template<typename... Args>
+        HybridAstarNodePtr Allocate(Args&&... args) {
+
+            // placement new
+            return new (NextSlot()) HybridAstarNode(std::forward<Args>(args)...);
+
+        }
+
+        // release all nodes in constant time, the memory blocks are kept for the next search
+        void Reset();
+
+        // how many nodes were built since the last reset
+        std::size_t Size() const;
+
+        // the total memory reserved by the arena, in bytes
+        std::size_t MemoryUsage() const;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef HYBRID_ASTAR_OPEN_SET_HPP
+#define HYBRID_ASTAR_OPEN_SET_HPP
+
+#include "HybridAstarNode.fwd.hpp"
+
+// the open set policy, selected at compile time
+// HYBRID_ASTAR_FIBONACCI_OPEN_SET: the old pointer based fibonacci heap
+// HYBRID_ASTAR_RADIX_OPEN_SET: monotone radix heap over the costs quantized in centimeters
+// default: the array based 4-ary heap
+#if defined(HYBRID_ASTAR_FIBONACCI_OPEN_SET)
+#include "../../PriorityQueue/PriorityQueue.hpp"
+#elif defined(HYBRID_ASTAR_RADIX_OPEN_SET)
+#include "../../PriorityQueue/RadixHeap.hpp"
+#else
+#include "../../PriorityQueue/DaryHeap.hpp"
+#endif
+
+namespace astar {
+
+#if defined(HYBRID_ASTAR_FIBONACCI_OPEN_SET)
+typedef astar::PriorityQueue<HybridAstarNodePtr> HybridAstarOpenSet;
+#elif defined(HYBRID_ASTAR_RADIX_OPEN_SET)
+typedef astar::RadixHeap<HybridAstarNodePtr> HybridAstarOpenSet;
+#else
+typedef astar::DaryHeap<HybridAstarNodePtr, 4> HybridAstarOpenSet;
+#endif
+
+}
+
+#endif
@@ -0,0 +1,463 @@
+// the hybrid A* search over random scenarios of a map: the anytime search costs within its budget
+// and the partial paths of the search limits, the expansion arcs against a dense sampling and the lazy against the eager paths
+// g++ -std=c++11 -O2 -I../.. HybridAstarTests.cpp HybridAstar.cpp HybridAstarNode.cpp HybridAstarNodeArena.cpp HybridAstarClosedSet.cpp Heuristics/Heuristic.cpp Heuristics/HolonomicHeuristic.cpp Heuristics/NonholonomicHeuristicInfo.cpp ../../GridMap/InternalGridMap.cpp ../../GridMap/GVDLau.cpp ../../VehicleModel/VehicleModel.cpp ../../ReedsShepp/ReedsSheppModel.cpp ../../ReedsShepp/ReedsSheppActionSet.cpp ../../Entities/Pose2D.cpp ../../Entities/State2D.cpp ../../Entities/Circle.cpp `pkg-config --cflags --libs opencv`
+// ./a.out <pgm map> [scenarios], the heuristic_info.bin or heuristic_info.txt file must be in the current directory
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include "HybridAstar.hpp"
+#include "Heuristics/Heuristic.hpp"
+
+// load the PGM file
+void loadPGM(std::istream &is, int *sizeX, int *sizeY, std::vector<double> &map)
+{
+	std::string tag;
+
+	is >> tag;
+	if (tag!="P5")
+	{
+		std::cerr << "Awaiting 'P5' in pgm header, found " << tag << std::endl;
+		exit(-1);
+	}
+
+	while (is.peek()==' ' || is.peek()=='\n') is.ignore();
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> *sizeX;
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> *sizeY;
+	while (is.peek()=='#') is.ignore(255, '\n');
+	is >> tag;
+	if (tag!="255")
+	{
+		std::cerr << "Awaiting '255' in pgm header, found " << tag << std::endl;
+		exit(-1);
+	}
+	is.ignore(255, '\n');
+
+	// the carmen maps are column major
+	map.assign((*sizeX) * (*sizeY), 0.0);
+
+	for (int y = *sizeY-1; y >= 0; --y)
+	{
+		for (int x = 0; x < *sizeX; ++x)
+		{
+			int c = is.get();
+
+			// cell is occupied
+			if ((double) c < 255-255*0.2) map[x * (*sizeY) + y] = 1.0;
+
+			if (!is.good())
+			{
+				std::cerr << "Error reading pgm map.\n";
+				exit(-1);
+			}
+		}
+	}
+}
+
+// the elapsed time in milliseconds
+double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// a single search result
+class SearchResult
+{
+	public:
+
+		// how many expanded nodes
+		unsigned int expanded;
+
+		// the search time
+		double time;
+
+		// the path size, zero if there's no path
+		unsigned int states;
+};
+
+// run a single search, the Reeds-Shepp shots use rand(), so the seed is reset before each search
+SearchResult Search(astar::HybridAstar &search, astar::InternalGridMap &grid, const astar::State2D &start, const astar::State2D &goal, unsigned int seed)
+{
+	SearchResult result;
+
+	srand(seed);
+
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	astar::StateArrayPtr path = search.FindPath(grid, start, goal);
+	result.time = ElapsedMilliseconds(t0);
+
+	result.expanded = search.GetExpandedNodes();
+	result.states = path->states.size();
+
+	delete path;
+
+	return result;
+}
+
+// stop the same search with each limit in turn, the partial path must end at the expanded node with the lowest heuristic
+// the expansions and the memory limits are half of what the full search used, the time limit a quarter
+// returns how many checks failed
+unsigned int LimitCheck(astar::HybridAstar &search, astar::InternalGridMap &grid, const astar::State2D &start, const astar::State2D &goal, unsigned int seed, const SearchResult &full)
+{
+	// the same heuristic as the search, it gives the value at the end of the partial path
+	astar::Heuristic heuristic(grid);
+	heuristic.UpdateHeuristic(grid, start, goal);
+
+	const char *names[] = { "expansions", "memory", "time" };
+	astar::SearchStatus expected[] = { astar::ExpansionLimitReached, astar::MemoryLimitReached, astar::DeadlineReached };
+
+	unsigned int failures = 0;
+
+	std::cout << "\nSearch limits over a search with " << full.expanded << " expanded nodes and " << full.time << " ms\n";
+
+	for (unsigned int k = 0; k < 3; ++k)
+	{
+		search.SetSearchLimits(
+			0 == k ? full.expanded / 2 : 0,
+			1 == k ? full.expanded / 2 * sizeof(astar::HybridAstarNode) : 0,
+			2 == k ? 0.00025 * full.time : 0.0);
+
+		srand(seed);
+		astar::StateArrayPtr path = search.FindPath(grid, start, goal);
+
+		bool status = expected[k] == search.GetSearchStatus();
+		bool partial = search.isPartialPath() && 0 < path->states.size();
+
+		// the path ends at the node the search kept as the closest one
+		double h = partial ? heuristic.GetHeuristicValue(path->states.back(), goal) : 0.0;
+		bool closest = partial && 1e-9 > std::fabs(h - search.GetClosestHeuristic());
+
+		std::cout << "  " << names[k] << " limit: " << search.GetExpandedNodes() << " expanded nodes, " << path->states.size() << " states, closest heuristic " << search.GetClosestHeuristic() << ", path end heuristic " << h << (status && partial && closest ? "\n" : ", FAILED\n");
+
+		failures += status && partial && closest ? 0 : 1;
+
+		delete path;
+	}
+
+	// the same expansions in the same order, a larger limit can only lower the closest heuristic
+	double previous = std::numeric_limits<double>::infinity();
+	unsigned int increases = 0;
+
+	for (unsigned int limit = 1; limit < full.expanded; limit <<= 1)
+	{
+		search.SetSearchLimits(limit, 0, 0.0);
+
+		srand(seed);
+		delete search.FindPath(grid, start, goal);
+
+		increases += previous < search.GetClosestHeuristic() ? 1 : 0;
+		previous = search.GetClosestHeuristic();
+	}
+
+	std::cout << "  the closest heuristic increased " << increases << " times while the expansion limit doubled\n";
+
+	search.SetSearchLimits(0, 0, 0.0);
+
+	return failures + increases;
+}
+
+// the conservative advancement against a pose every centimeter along the same arcs, from random safe poses
+// the advancement may accept an arc the dense sampling rejects, but only within the distance map rounding:
+// a cell diagonal, plus the circle motion over the smallest step when the clearance is below it
+// returns how many arcs went deeper than that
+unsigned int ArcCheck(astar::VehicleModel &vehicle, astar::InternalGridMap &grid, double width, double height, unsigned int samples)
+{
+	astar::HybridAstar search(vehicle, grid);
+
+	double resolution = grid.GetResolution();
+	double k = vehicle.footprint.reach / vehicle.min_turn_radius;
+	double bound = resolution * (std::sqrt(2.0) + 0.5 * std::sqrt(1.0 + k * k));
+
+	std::mt19937 generator(23);
+	std::uniform_real_distribution<double> x(0.0, width), y(0.0, height), t(-M_PI, M_PI), l(resolution, 5.0);
+
+	unsigned int arcs = 0, end_safe = 0, dense_safe = 0, advancement_safe = 0, missed = 0, deeper = 0;
+	double deepest = 0.0;
+
+	for (unsigned int i = 0; i < samples;)
+	{
+		astar::Pose2D start(x(generator), y(generator), t(generator));
+
+		if (!grid.isSafePlace(start, vehicle.footprint, vehicle.safety_factor))
+		{
+			continue;
+		}
+
+		double length = l(generator);
+		double clearance = std::max(0.0, grid.GetClearance(start.position, start.orientation, vehicle.footprint, vehicle.safety_factor));
+
+		for (unsigned int g = 0; g < astar::NumGears; ++g)
+		{
+			for (unsigned int s = 0; s < astar::NumSteering; ++s)
+			{
+				astar::Steer steer = static_cast<astar::Steer>(s);
+				astar::Gear gear = static_cast<astar::Gear>(g);
+
+				arcs++;
+
+				// the search verifies the end pose first
+				if (!grid.isSafePlace(vehicle.NextPose(start, steer, gear, length, vehicle.min_turn_radius), vehicle.footprint, vehicle.safety_factor))
+				{
+					continue;
+				}
+
+				end_safe++;
+
+				// the deepest pose along the arc, a negative clearance is inside the unsafe region
+				double depth = 0.0;
+
+				for (double d = 0.01; d < length; d += 0.01)
+				{
+					astar::Pose2D pose(vehicle.NextPose(start, steer, gear, d, vehicle.min_turn_radius));
+
+					depth = std::max(depth, -grid.GetClearance(pose.position, pose.orientation, vehicle.footprint, vehicle.safety_factor));
+				}
+
+				bool dense = 0.0 >= depth;
+				bool advancement = search.isSafeArc(start, clearance, steer, gear, length);
+
+				dense_safe += dense ? 1 : 0;
+				advancement_safe += advancement ? 1 : 0;
+
+				if (advancement && !dense)
+				{
+					missed++;
+					deepest = std::max(deepest, depth);
+					deeper += bound < depth ? 1 : 0;
+				}
+			}
+		}
+
+		++i;
+	}
+
+	std::cout << "\nThe expansion arcs of " << samples << " random safe poses, " << arcs << " arcs\n";
+	std::cout << "  end pose safe: " << end_safe << ", dense sampling safe: " << dense_safe << ", conservative advancement safe: " << advancement_safe << "\n";
+	std::cout << "  " << missed << " arcs accepted against the dense sampling, the deepest one " << deepest << " m inside the unsafe region, " << deeper << " deeper than " << bound << " m\n";
+
+	return deeper;
+}
+
+// the same searches with the eager and the lazy collision checking, with and without the motion primitives
+// the lazy search verifies the same children, only later, so it must find the same paths
+// returns how many paths differ
+unsigned int LazyCheck(astar::VehicleModel &vehicle, astar::InternalGridMap &grid, const std::vector<astar::State2D> &starts, const std::vector<astar::State2D> &goals)
+{
+	unsigned int failures = 0;
+
+	for (unsigned int m = 0; m < 2; ++m)
+	{
+		astar::HybridAstar eager(vehicle, grid), lazy(vehicle, grid);
+		eager.SetMotionPrimitives(1 == m);
+		lazy.SetMotionPrimitives(1 == m);
+		lazy.SetLazyCollisionChecking(true);
+
+		unsigned int found = 0, different = 0;
+		unsigned long eager_checks = 0, lazy_checks = 0, eager_expanded = 0, lazy_expanded = 0;
+
+		for (unsigned int i = 0; i < starts.size(); ++i)
+		{
+			srand(i);
+			astar::StateArrayPtr a = eager.FindPath(grid, starts[i], goals[i]);
+			eager_checks += eager.GetCollisionChecks();
+			eager_expanded += eager.GetExpandedNodes();
+
+			srand(i);
+			astar::StateArrayPtr b = lazy.FindPath(grid, starts[i], goals[i]);
+			lazy_checks += lazy.GetCollisionChecks();
+			lazy_expanded += lazy.GetExpandedNodes();
+
+			bool equal = a->states.size() == b->states.size();
+
+			for (unsigned int k = 0; equal && k < a->states.size(); ++k)
+			{
+				equal = 1e-9 > a->states[k].position.Distance(b->states[k].position) &&
+						1e-9 > std::fabs(a->states[k].orientation - b->states[k].orientation) &&
+						a->states[k].gear == b->states[k].gear;
+			}
+
+			found += a->states.empty() ? 0 : 1;
+			different += equal ? 0 : 1;
+
+			delete a;
+			delete b;
+		}
+
+		std::cout << "\nThe lazy collision checking " << (1 == m ? "with" : "without") << " the motion primitives, the eager search found " << found << " paths of " << starts.size() << " scenarios, " << different << " lazy paths differ\n";
+		std::cout << "  eager: " << eager_checks << " verified children, " << eager_expanded << " expanded nodes\n";
+		std::cout << "  lazy:  " << lazy_checks << " verified children, " << lazy_expanded << " expanded nodes\n";
+
+		failures += different;
+	}
+
+	return failures;
+}
+
+// the anytime search over the scenarios, the weight goes from 3 to 1 in 0.5 steps within a 1 s budget
+// returns how many checks failed
+unsigned int AnytimeCheck(astar::VehicleModel &vehicle, astar::InternalGridMap &grid, const std::vector<astar::State2D> &starts, const std::vector<astar::State2D> &goals)
+{
+	const double weight = 3.0, weight_step = 0.5, budget = 1.0;
+	const unsigned int weights = 5;
+
+	astar::HybridAstar anytime(vehicle, grid);
+	anytime.SetAnytimeSearch(weight, weight_step, budget);
+
+	// how many paths each weight improved and the mean cost ratio to the first path
+	std::vector<unsigned int> anytime_paths(weights, 0);
+	std::vector<double> anytime_ratio(weights, 0.0);
+	unsigned int anytime_found = 0, anytime_improved = 0, over_budget = 0, failures = 0;
+	double anytime_longest = 0.0;
+
+	for (unsigned int i = 0; i < starts.size(); ++i)
+	{
+		SearchResult c = Search(anytime, grid, starts[i], goals[i], i);
+
+		// the deadline is verified every 32 nodes, a tenth of the budget is enough for the last ones
+		anytime_longest = std::max(anytime_longest, c.time);
+		over_budget += 1100.0 * budget < c.time ? 1 : 0;
+
+		const std::vector<std::pair<double, double>> &solutions(anytime.GetAnytimeSolutions());
+
+		if (0 < solutions.size())
+		{
+			anytime_found++;
+			anytime_improved += 1 < solutions.size() ? 1 : 0;
+
+			for (unsigned int k = 0; k < solutions.size(); ++k)
+			{
+				// a path is kept only when it's cheaper than the previous one
+				if (0 < k && solutions[k].second >= solutions[k - 1].second)
+				{
+					failures++;
+				}
+
+				unsigned int w = std::min((unsigned int) std::floor((weight - solutions[k].first) / weight_step + 0.5), weights - 1);
+
+				anytime_paths[w]++;
+				anytime_ratio[w] += solutions[k].second / solutions[0].second;
+			}
+		}
+	}
+
+	std::cout << "\nThe anytime search found a path in " << anytime_found << " of " << starts.size() << " scenarios, " << anytime_improved << " improved it within " << budget << " s\n";
+
+	for (unsigned int w = 0; w < weights; ++w)
+	{
+		std::cout << "  weight " << weight - w * weight_step << ": " << anytime_paths[w] << " paths, mean cost " << (0 < anytime_paths[w] ? anytime_ratio[w] / anytime_paths[w] : 0.0) << " of the first path\n";
+	}
+
+	std::cout << "  " << over_budget << " searches over the budget, the longest took " << anytime_longest << " ms\n";
+
+	return failures + over_budget;
+}
+
+int main (int argc, char **argv)
+{
+	if (2 > argc)
+	{
+		std::cerr << "usage: " << argv[0] << " <pgm map> [scenarios]\n";
+		exit(-1);
+	}
+
+	std::ifstream is(argv[1]);
+	if (!is.is_open())
+	{
+		std::cerr << "Could not open map file for reading.\n";
+		exit(-1);
+	}
+
+	unsigned int scenarios = 2 < argc ? std::atoi(argv[2]) : 50;
+
+	int width, height;
+	std::vector<double> map;
+
+	loadPGM(is, &width, &height, map);
+	is.close();
+
+	// the grid map, 0.2 m cells
+	double resolution = 0.2;
+	astar::InternalGridMap grid;
+	grid.UpdateGridMap(height, width, resolution, astar::Vector2D<double>(0.0, 0.0), &map[0]);
+	grid.UpdateVoronoiDiagram();
+
+	// the ford escape parameters
+	astar::VehicleModel vehicle;
+	vehicle.length = 4.425;
+	vehicle.width = 1.806;
+	vehicle.axledist = 2.625;
+	vehicle.rear_car_wheels_dist = 0.96;
+	vehicle.max_wheel_deflection = 0.5337;
+	vehicle.understeer = 0.0015;
+	vehicle.max_curvature = 0.22;
+	vehicle.safety_factor = 1.0;
+	vehicle.Configure();
+
+	// the scenario set, safe start and goal poses between 10 and 40 meters apart
+	std::mt19937 generator(19);
+	std::uniform_real_distribution<double> x(0.0, width * resolution), y(0.0, height * resolution), t(-M_PI, M_PI);
+
+	std::vector<astar::State2D> starts, goals;
+
+	while (starts.size() < scenarios)
+	{
+		astar::State2D start, goal;
+
+		start.position = astar::Vector2D<double>(x(generator), y(generator));
+		start.orientation = t(generator);
+		goal.position = astar::Vector2D<double>(x(generator), y(generator));
+		goal.orientation = t(generator);
+
+		double distance = start.position.Distance(goal.position);
+
+		if (10.0 > distance || 40.0 < distance ||
+			!grid.isSafePlace(start.position, start.orientation, vehicle.footprint, vehicle.safety_factor) ||
+			!grid.isSafePlace(goal.position, goal.orientation, vehicle.footprint, vehicle.safety_factor))
+		{
+			continue;
+		}
+
+		// the first step length
+		start.v = 1.0;
+		start.t = resolution;
+
+		starts.push_back(start);
+		goals.push_back(goal);
+	}
+
+	unsigned int failures = ArcCheck(vehicle, grid, width * resolution, height * resolution, 20000);
+
+	failures += LazyCheck(vehicle, grid, starts, goals);
+	failures += AnytimeCheck(vehicle, grid, starts, goals);
+
+	// the limits are verified once, over the first search with enough expansions
+	astar::HybridAstar search(vehicle, grid);
+	unsigned int limited = 0;
+
+	for (; limited < starts.size(); ++limited)
+	{
+		SearchResult full = Search(search, grid, starts[limited], goals[limited], limited);
+
+		if (0 < full.states && 10000 < full.expanded)
+		{
+			failures += LimitCheck(search, grid, starts[limited], goals[limited], limited, full);
+			break;
+		}
+	}
+
+	if (starts.size() == limited)
+	{
+		std::cout << "\nNo search with enough expansions to verify the limits\n";
+		failures++;
+	}
+
+	return 0 == failures ? 0 : 1;
+}
@@ -35,9 +35,45 @@ HybridAstarPathFinder::get_parameters(int argc, char **argv)
     // hard setup
     simulation_mode = true;
 
+    // the default closed set angular resolution, 5 degrees
+    heading_bins = 72;
+
+    // the voronoi diagram update metrics are not reported by default
+    gvd_metrics = false;
+
+    // the nearest cell nonholonomic heuristic lookup by default
+    interpolated_heuristic = false;
+
+    // the vehicle model expansions by default
+    motion_primitives = false;
+
+    // the children are verified when they are built by default
+    lazy_collision = false;
+
+    // the plain search by default, the anytime search needs a weight above one
+    anytime_weight = 1.0;
+    anytime_weight_step = 0.5;
+    anytime_budget = 0.1;
+
+    // no search limits by default, the memory limit in megabytes
+    max_expanded_nodes = 0;
+    max_node_memory = 0;
+    max_search_time = 0.0;
+
     carmen_param_t planner_params_list[] = {
             //get the motion planner parameters
             {(char *)"astar",   (char *)"simulation_mode",                           	CARMEN_PARAM_ONOFF, &this->simulation_mode,                    		                    1, NULL},
+            {(char *)"astar",   (char *)"heading_bins",                              	CARMEN_PARAM_INT, &this->heading_bins,                    		                        1, NULL},
+            {(char *)"astar",   (char *)"gvd_metrics",                              	CARMEN_PARAM_ONOFF, &this->gvd_metrics,                    		                        1, NULL},
+            {(char *)"astar",   (char *)"interpolated_heuristic",                      	CARMEN_PARAM_ONOFF, &this->interpolated_heuristic,                    		            1, NULL},
+            {(char *)"astar",   (char *)"motion_primitives",                           	CARMEN_PARAM_ONOFF, &this->motion_primitives,                    		                1, NULL},
+            {(char *)"astar",   (char *)"lazy_collision",                              	CARMEN_PARAM_ONOFF, &this->lazy_collision,                    		                    1, NULL},
+            {(char *)"astar",   (char *)"anytime_weight",                              	CARMEN_PARAM_DOUBLE, &this->anytime_weight,                    		                    1, NULL},
+            {(char *)"astar",   (char *)"anytime_weight_step",                         	CARMEN_PARAM_DOUBLE, &this->anytime_weight_step,                    		            1, NULL},
+            {(char *)"astar",   (char *)"anytime_budget",                              	CARMEN_PARAM_DOUBLE, &this->anytime_budget,                    		                    1, NULL},
+            {(char *)"astar",   (char *)"max_expanded_nodes",                          	CARMEN_PARAM_INT, &this->max_expanded_nodes,                    		                    1, NULL},
+            {(char *)"astar",   (char *)"max_node_memory",                             	CARMEN_PARAM_INT, &this->max_node_memory,                    		                    1, NULL},
+            {(char *)"astar",   (char *)"max_search_time",                             	CARMEN_PARAM_DOUBLE, &this->max_search_time,                    		                    1, NULL},
     };
 
     // vehicle parameters
@@ -77,6 +113,27 @@ HybridAstarPathFinder::get_parameters(int argc, char **argv)
     // do some pre-computations and update some indirect parameters
     vehicle_model.Configure();
 
+    // set the closed set angular resolution
+    path_finder.SetHeadingResolution(0 < heading_bins ? heading_bins : 1);
+
+    // the heuristic table lookup
+    path_finder.SetInterpolatedHeuristic(interpolated_heuristic);
+
+    // the node expansions
+    path_finder.SetMotionPrimitives(motion_primitives);
+
+    // the children collision checks
+    path_finder.SetLazyCollisionChecking(lazy_collision);
+
+    // the anytime search, it must fit in the planner cycle
+    path_finder.SetAnytimeSearch(anytime_weight, anytime_weight_step, anytime_budget);
+
+    // the search limits, the map stays locked during the search
+    path_finder.SetSearchLimits(
+        0 < max_expanded_nodes ? max_expanded_nodes : 0,
+        0 < max_node_memory ? static_cast<std::size_t>(max_node_memory) << 20 : 0,
+        max_search_time);
+
     simulation_mode = false;
 
 }
@@ -97,6 +154,18 @@ HybridAstarPathFinder::replan() {
         // find the path to the goal
         StateArrayPtr raw_path = path_finder.FindPath(grid, robot, goal);
 
+        if (path_finder.isPartialPath()) {
+
+            // the partial path doesn't reach the goal, keep the current path
+            std::cout << "Hybrid A* search stopped by the " <<
+                (ExpansionLimitReached == path_finder.GetSearchStatus() ? "expansion" :
+                 MemoryLimitReached == path_finder.GetSearchStatus() ? "memory" : "time") <<
+                " limit after " << path_finder.GetExpandedNodes() << " expanded nodes" << std::endl;
+
+            raw_path->states.clear();
+
+        }
+
         if (0 < raw_path->states.size()) {
 
             // smoooth the current path
@@ -152,7 +221,7 @@ HybridAstarPathFinder::set_goal_state(const State2D &goal_state) {
     if (initialized_grid_map) {
 
         // verify the safety
-        activated = valid_goal = grid.isSafePlace(vehicle_model.GetVehicleBodyCircles(goal_state), vehicle_model.safety_factor);
+        activated = valid_goal = grid.isSafePlace(goal_state, vehicle_model.footprint, vehicle_model.safety_factor);
 
         return;
     }
@@ -200,7 +269,7 @@ HybridAstarPathFinder::set_goal_state(double x, double y, double theta, double v
     if (initialized_grid_map) {
 
         // verify the safety
-        valid_goal = grid.isSafePlace(vehicle_model.GetVehicleBodyCircles(goal), vehicle_model.safety_factor);
+        valid_goal = grid.isSafePlace(goal, vehicle_model.footprint, vehicle_model.safety_factor);
 
         return;
     }
@@ -270,26 +339,12 @@ HybridAstarPathFinder::voronoi_update(carmen_map_server_compact_cost_map_message
     double resolution = msg->config.resolution;
     double inverse_resolution = 1.0/resolution;
 
-    grid.UpdateGridMap(msg->config.y_size, msg->config.x_size, resolution, Vector2D<double>(x_origin, y_origin), msg->value);
-
-    int *x_coord = msg->coord_x;
-    int *y_coord = msg->coord_y;
-    double *val = msg->value;
-    unsigned int size = msg->size;
-
-
-    for (unsigned int i = 0; i < size; i++) {
+    // the values are a sparse list of cells, not a whole map
+    grid.UpdateCompactGridMap(msg->config.y_size, msg->config.x_size, resolution, Vector2D<double>(x_origin, y_origin),
+            msg->size, msg->coord_y, msg->coord_x, msg->value);
 
-        if (0.5 < val[i]) {
-            grid.OccupyCell(y_coord[i], x_coord[i]);
-        } else {
-            grid.ClearCell(y_coord[i], x_coord[i]);
-        }
-
-    }
-
-    // update the entire grid map
-    grid.ProcessVoronoiDiagram();
+    // feed the changed cells and update the voronoi diagram
+    grid.UpdateVoronoiDiagram();
 
     // unlock the given mutex
     gm_mutex.unlock();
@@ -300,16 +355,10 @@ HybridAstarPathFinder::voronoi_update(carmen_map_server_compact_cost_map_message
 void
 HybridAstarPathFinder::voronoi_update_2(carmen_mapper_map_message *msg) {
 
-    unsigned int row, col, index;
     double x_origin = msg->config.x_origin;
     double y_origin = msg->config.y_origin;
     double resolution = msg->config.resolution;
     double inverse_resolution = 1.0/resolution;
-    double *val = msg->complete_map;
-
-    unsigned int width = msg->config.x_size;
-    unsigned int height = msg->config.y_size;
-    unsigned int size = msg->size;
 
     grid.UpdateGridMap(msg->config.y_size, msg->config.x_size, resolution, Vector2D<double>(x_origin, y_origin), msg->complete_map);
 
@@ -317,69 +366,20 @@ HybridAstarPathFinder::voronoi_update_2(carmen_mapper_map_message *msg) {
 
     //unsigned int c_size = grid.GetCorridorIndexes();
 
-    if (false) {
-
-        astar::GridMap grid_map(grid.grid_map);
-
-        for (unsigned int row = 0; row < height; ++row) {
+    // only the cells whose occupied state changed since the last message are fed to the voronoi diagram
+    grid.UpdateVoronoiDiagram();
 
-            for (unsigned int col = 0; col < width; ++col) {
+    if (gvd_metrics) {
 
-                // get the cell
-                GridMapCellRef c(grid_map[row][col]);
+        // get the last update metrics
+        const GVDUpdateMetrics &metrics(grid.GetGVDMetrics());
 
-                if (c.is_corridor) {
-
-                    if (0.4 < c.occupancy) {
-
-                        grid.OccupyCell(row, col);
-
-                    } else {
-
-                        grid.SetSimpleFreeSpace(row, col);
-                        // grid.ClearCell(row, col);
-
-                    }
-
-
-                } else {
-
-                    grid.SetSimpleObstacle(row, col);
-
-                }
-            }
-
-        }
-
-    } else {
-
-        astar::GridMap grid_map(grid.grid_map);
-
-        for (unsigned int row = 0; row < height; ++row) {
-
-            for (unsigned int col = 0; col < width; ++col) {
-
-                GridMapCellRef c(grid_map[row][col]);
-
-                if (0.4 < c.occupancy) {
-
-                    grid.OccupyCell(row, col);
-
-                } else {
-
-                    grid.ClearCell(row, col);
-
-                }
-
-            }
-
-        }
+        std::cout << "GVD update: " << metrics.changed_cells << "/" << metrics.total_cells << " changed cells, "
+                  << metrics.elapsed * 1000.0 << " ms, window shift (" << metrics.row_shift << ", " << metrics.col_shift << ")"
+                  << (metrics.full_rebuild ? ", full rebuild" : "") << "\n";
 
     }
 
-    // process the voronoi diagram
-    grid.ProcessVoronoiDiagram();
-
     // set the initialized flag
     initialized_grid_map = true;
 
@@ -76,6 +76,40 @@ class HybridAstarPathFinder {
         // the RDDF vector
         std::vector<astar::Vector2D<double>> rddf;
 
+        // the number of heading bins used by the search closed set
+        int heading_bins;
+
+        // flag to report the voronoi diagram update metrics after each map message
+        int gvd_metrics;
+
+        // flag to use the interpolated nonholonomic heuristic lookup
+        int interpolated_heuristic;
+
+        // flag to expand the nodes with the precomputed motion primitives
+        int motion_primitives;
+
+        // flag to verify the children only when they leave the open set
+        int lazy_collision;
+
+        // the anytime search initial heuristic weight, the plain search when it is not above one
+        double anytime_weight;
+
+        // the heuristic weight decrease after each anytime solution
+        double anytime_weight_step;
+
+        // the anytime search wall clock budget, in seconds
+        double anytime_budget;
+
+        // the maximum number of expanded nodes in a single search, zero means no limit
+        int max_expanded_nodes;
+
+        // the maximum memory of a single search, in megabytes, zero means no limit
+        // the nodes, the closed set entries and the Reeds-Shepp action sets
+        int max_node_memory;
+
+        // the maximum wall clock time of a single search, in seconds, zero means no limit
+        double max_search_time;
+
         // PRIVATE METHODS
 
         // get all the necessary parameters
@@ -1,5 +1,7 @@
 #include "CGSmoother.hpp"
 
+#include <iostream>
+
 #include <opencv2/opencv.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -60,7 +62,7 @@ bool astar::CGSmoother::UnsafePath(astar::Vector2DArrayPtr<double> path) {
 
         if (!locked_positions[i]) {
 
-            if (!grid.isSafePlace(vehicle.GetVehicleBodyCircles(positions[i], poses[j].orientation), safety)) {
+            if (!grid.isSafePlace(positions[i], poses[j].orientation, vehicle.footprint, safety)) {
 
                 // lock the current point
                 locked_positions[i] = true;
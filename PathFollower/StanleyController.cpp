@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <array>
+#include <iostream>
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/highgui/highgui.hpp>
@@ -0,0 +1,248 @@
+#ifndef DARY_HEAP_TEMPLATE_HPP
+#define DARY_HEAP_TEMPLATE_HPP
+
+#include <vector>
+#include <climits>
+
+namespace astar {
+
+    // an array based d-ary min heap with decrease key
+    // the handles are just indexes to the position vector, so there's no allocation per element
+    // same interface as the fibonacci PriorityQueue
+    template<typename T, unsigned int D = 4>
+    class DaryHeap {
+
+        public:
+
+            // the element handle
+            typedef unsigned int Handle;
+
+        private:
+
+            // a single heap entry
+            class Entry {
+
+                public:
+
+                    // the key
+                    double Key;
+
+                    // the external object
+                    T element;
+
+                    // the handle
+                    Handle id;
+
+            };
+
+            // PRIVATE ATTRIBUTES
+
+            // the heap array
+            std::vector<Entry> heap;
+
+            // the current heap position of each handle
+            std::vector<unsigned int> position;
+
+            // the null value
+            T null_value;
+
+            // PRIVATE METHODS
+
+            // move the entry at the given position to its place
+            void SiftUp(unsigned int i) {
+
+                // save the current entry
+                Entry e(heap[i]);
+
+                while (0 < i) {
+
+                    // the parent index
+                    unsigned int p = (i - 1) / D;
+
+                    if (heap[p].Key <= e.Key) {
+
+                        break;
+
+                    }
+
+                    // move the parent down
+                    heap[i] = heap[p];
+                    position[heap[i].id] = i;
+
+                    i = p;
+
+                }
+
+                // place the entry
+                heap[i] = e;
+                position[e.id] = i;
+
+            }
+
+            // move the entry at the given position to its place
+            void SiftDown(unsigned int i) {
+
+                // save the current entry
+                Entry e(heap[i]);
+
+                // the heap size
+                unsigned int n = heap.size();
+
+                while (true) {
+
+                    // the first child index
+                    unsigned int first = i * D + 1;
+
+                    if (first >= n) {
+
+                        break;
+
+                    }
+
+                    // the last child index
+                    unsigned int last = first + D < n ? first + D : n;
+
+                    // find the smallest child
+                    unsigned int c = first;
+                    for (unsigned int j = first + 1; j < last; ++j) {
+
+                        if (heap[j].Key < heap[c].Key) {
+
+                            c = j;
+
+                        }
+
+                    }
+
+                    if (e.Key <= heap[c].Key) {
+
+                        break;
+
+                    }
+
+                    // move the child up
+                    heap[i] = heap[c];
+                    position[heap[i].id] = i;
+
+                    i = c;
+
+                }
+
+                // place the entry
+                heap[i] = e;
+                position[e.id] = i;
+
+            }
+
+        public:
+
+            // PUBLIC METHODS
+
+            // basic constructor
+            DaryHeap(T _null) : heap(), position(), null_value(_null) {}
+
+            // insert a new element in the priority queue
+            Handle Add(T element, double Key) {
+
+                // the new handle
+                Handle id = position.size();
+
+                // build the entry
+                Entry e;
+                e.Key = Key;
+                e.element = element;
+                e.id = id;
+
+                // save the entry at the bottom
+                position.push_back(heap.size());
+                heap.push_back(e);
+
+                // restore the heap property
+                SiftUp(heap.size() - 1);
+
+                return id;
+
+            }
+
+            // get the min element
+            T Min() {
+
+                return heap.empty() ? null_value : heap.front().element;
+
+            }
+
+            // extract the min element
+            T DeleteMin() {
+
+                if (heap.empty()) {
+
+                    return null_value;
+
+                }
+
+                // get the min element
+                T element = heap.front().element;
+
+                // the handle is not valid anymore
+                position[heap.front().id] = UINT_MAX;
+
+                // move the last entry to the top
+                heap.front() = heap.back();
+                heap.pop_back();
+
+                if (!heap.empty()) {
+
+                    // restore the heap property
+                    SiftDown(0);
+
+                }
+
+                return element;
+
+            }
+
+            // update the heap after a decrease key
+            void DecreaseKey(Handle id, double Key) {
+
+                if (id < position.size() && UINT_MAX != position[id]) {
+
+                    // get the heap position
+                    unsigned int i = position[id];
+
+                    if (Key < heap[i].Key) {
+
+                        // update the key
+                        heap[i].Key = Key;
+
+                        // restore the heap property
+                        SiftUp(i);
+
+                    }
+
+                }
+
+            }
+
+            // is empty?
+            bool isEmpty() {
+
+                return heap.empty();
+
+            }
+
+            // delete the entire heap, the memory is kept for the next usage
+            void ClearHeap() {
+
+                heap.clear();
+                position.clear();
+
+            }
+
+            // how many elements
+            unsigned int GetN() { return heap.size(); }
+
+    };
+
+}
+
+#endif
@@ -16,6 +16,11 @@ namespace astar {
     template<typename T>
     class PriorityQueue {
 
+        public:
+
+            // the element handle
+            typedef astar::PriorityQueueNodePtr<T> Handle;
+
         private:
 
             // PRIVATE ATTRIBUTES
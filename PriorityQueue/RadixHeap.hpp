@@ -0,0 +1,295 @@
+#ifndef RADIX_HEAP_TEMPLATE_HPP
+#define RADIX_HEAP_TEMPLATE_HPP
+
+#include <vector>
+#include <climits>
+#include <cmath>
+
+namespace astar {
+
+    // a monotone radix heap over integer quantized keys
+    // the keys are quantized as floor(Key * scale) and any key below the last extracted one is clamped to it,
+    // so the extraction order is exact only with a consistent heuristic, up to the quantization step
+    // the decrease key operation pushes a new entry and the old one is skipped later
+    // same interface as the fibonacci PriorityQueue
+    template<typename T>
+    class RadixHeap {
+
+        public:
+
+            // the element handle
+            typedef unsigned int Handle;
+
+        private:
+
+            // the number of buckets, one for each bit plus the last extracted key bucket
+            static const unsigned int NumBuckets = sizeof(unsigned long long) * 8 + 1;
+
+            // a single bucket entry
+            class Entry {
+
+                public:
+
+                    // the quantized key
+                    unsigned long long Key;
+
+                    // the handle
+                    Handle id;
+
+            };
+
+            // PRIVATE ATTRIBUTES
+
+            // the buckets
+            std::vector<Entry> buckets[NumBuckets];
+
+            // the current quantized key of each handle, ULLONG_MAX after the extraction
+            std::vector<unsigned long long> current;
+
+            // the external object of each handle
+            std::vector<T> elements;
+
+            // the last extracted key
+            unsigned long long last;
+
+            // how many valid elements
+            unsigned int N;
+
+            // the key scale
+            double scale;
+
+            // the null value
+            T null_value;
+
+            // PRIVATE METHODS
+
+            // quantize a given key
+            unsigned long long Quantize(double Key) {
+
+                // negative keys are clamped to zero
+                unsigned long long k = 0.0 < Key ? static_cast<unsigned long long>(std::floor(Key * scale)) : 0;
+
+                // the monotone property
+                return k < last ? last : k;
+
+            }
+
+            // get the bucket index given a key
+            unsigned int BucketIndex(unsigned long long k) {
+
+                return k == last ? 0 : NumBuckets - 1 - __builtin_clzll(k ^ last);
+
+            }
+
+            // push the entry to the appropriated bucket
+            void Push(const Entry &e) {
+
+                buckets[BucketIndex(e.Key)].push_back(e);
+
+            }
+
+            // move the smallest key to the first bucket
+            bool Refill() {
+
+                for (unsigned int i = 1; i < NumBuckets; ++i) {
+
+                    // the bucket reference
+                    std::vector<Entry> &bucket(buckets[i]);
+
+                    // find the new last key, skipping the old entries
+                    unsigned long long new_last = ULLONG_MAX;
+                    for (typename std::vector<Entry>::iterator it = bucket.begin(); it != bucket.end(); ++it) {
+
+                        if (current[it->id] == it->Key && it->Key < new_last) {
+
+                            new_last = it->Key;
+
+                        }
+
+                    }
+
+                    if (ULLONG_MAX != new_last) {
+
+                        // update the last key
+                        last = new_last;
+
+                        // redistribute the valid entries, they all go to lower buckets
+                        for (typename std::vector<Entry>::iterator it = bucket.begin(); it != bucket.end(); ++it) {
+
+                            if (current[it->id] == it->Key) {
+
+                                Push(*it);
+
+                            }
+
+                        }
+
+                    }
+
+                    // the capacity is kept
+                    bucket.clear();
+
+                    if (ULLONG_MAX != new_last) {
+
+                        return true;
+
+                    }
+
+                }
+
+                return false;
+
+            }
+
+            // remove the old entries from the first bucket top
+            bool PrepareMin() {
+
+                while (0 < N) {
+
+                    // get the first bucket
+                    std::vector<Entry> &bucket(buckets[0]);
+
+                    // discard the old entries
+                    while (!bucket.empty() && current[bucket.back().id] != bucket.back().Key) {
+
+                        bucket.pop_back();
+
+                    }
+
+                    if (!bucket.empty()) {
+
+                        return true;
+
+                    }
+
+                    if (!Refill()) {
+
+                        return false;
+
+                    }
+
+                }
+
+                return false;
+
+            }
+
+        public:
+
+            // PUBLIC METHODS
+
+            // basic constructor, the default scale quantizes the costs in centimeters
+            RadixHeap(T _null, double _scale = 100.0) : current(), elements(), last(0), N(0), scale(_scale), null_value(_null) {}
+
+            // insert a new element in the priority queue
+            Handle Add(T element, double Key) {
+
+                // the new handle
+                Handle id = current.size();
+
+                // build the entry
+                Entry e;
+                e.Key = Quantize(Key);
+                e.id = id;
+
+                // save the current key and the element
+                current.push_back(e.Key);
+                elements.push_back(element);
+
+                // save the entry
+                Push(e);
+
+                // update the counter
+                N += 1;
+
+                return id;
+
+            }
+
+            // get the min element
+            T Min() {
+
+                return PrepareMin() ? elements[buckets[0].back().id] : null_value;
+
+            }
+
+            // extract the min element
+            T DeleteMin() {
+
+                if (!PrepareMin()) {
+
+                    return null_value;
+
+                }
+
+                // get the entry
+                Entry e(buckets[0].back());
+                buckets[0].pop_back();
+
+                // the handle is not valid anymore
+                current[e.id] = ULLONG_MAX;
+
+                // update the counter
+                N -= 1;
+
+                return elements[e.id];
+
+            }
+
+            // update the heap after a decrease key
+            void DecreaseKey(Handle id, double Key) {
+
+                if (id < current.size() && ULLONG_MAX != current[id]) {
+
+                    // quantize the new key
+                    unsigned long long k = Quantize(Key);
+
+                    if (k < current[id]) {
+
+                        // the old entry will be skipped
+                        current[id] = k;
+
+                        // push the new entry
+                        Entry e;
+                        e.Key = k;
+                        e.id = id;
+
+                        Push(e);
+
+                    }
+
+                }
+
+            }
+
+            // is empty?
+            bool isEmpty() {
+
+                return 0 == N;
+
+            }
+
+            // delete the entire heap, the memory is kept for the next usage
+            void ClearHeap() {
+
+                for (unsigned int i = 0; i < NumBuckets; ++i) {
+
+                    buckets[i].clear();
+
+                }
+
+                current.clear();
+                elements.clear();
+                last = 0;
+                N = 0;
+
+            }
+
+            // how many elements
+            unsigned int GetN() { return N; }
+
+    };
+
+}
+
+#endif
@@ -1,13 +1,282 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 
 #include <vector>
 #include <random>
 #include <cmath>
 #include <climits>
+#include <chrono>
+#include <string>
+#include <unordered_map>
 
 #include "PriorityQueue.hpp"
+#include "DaryHeap.hpp"
+#include "RadixHeap.hpp"
 
-int main() {
+// a single open set operation
+class TraceOperation {
+
+    public:
+
+        // s: new search, a: add, d: decrease key, p: delete min
+        char op;
+
+        // the element id, dense inside each search
+        unsigned int id;
+
+        // the key
+        double key;
+
+};
+
+// load a trace recorded by HybridAstar with HYBRID_ASTAR_TRACE_OPEN_SET
+bool LoadTrace(const std::string &filename, std::vector<TraceOperation> &trace) {
+
+    std::ifstream file(filename.c_str());
+
+    if (!file.is_open()) {
+
+        return false;
+
+    }
+
+    // map the node addresses to dense ids, per search
+    std::unordered_map<unsigned long long, unsigned int> ids;
+
+    std::string line;
+    while (std::getline(file, line)) {
+
+        std::istringstream iss(line);
+
+        TraceOperation t;
+        unsigned long long address = 0;
+
+        t.id = 0;
+        t.key = 0.0;
+
+        if (!(iss >> t.op)) {
+
+            continue;
+
+        }
+
+        if ('s' == t.op) {
+
+            ids.clear();
+
+        } else if ('a' == t.op || 'd' == t.op) {
+
+            iss >> address >> t.key;
+
+            // get the dense id
+            std::unordered_map<unsigned long long, unsigned int>::iterator it = ids.find(address);
+
+            if (ids.end() == it) {
+
+                it = ids.insert(std::make_pair(address, (unsigned int) ids.size())).first;
+
+            }
+
+            t.id = it->second;
+
+        }
+
+        trace.push_back(t);
+
+    }
+
+    return true;
+
+}
+
+// build a synthetic A* like trace: pop the min node and push its children with greater keys
+void SyntheticTrace(unsigned int searches, unsigned int expansions, std::vector<TraceOperation> &trace) {
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> step(0.2, 5.0);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    for (unsigned int s = 0; s < searches; ++s) {
+
+        // the reference queue
+        astar::DaryHeap<unsigned int, 4> queue(UINT_MAX);
+        std::vector<astar::DaryHeap<unsigned int, 4>::Handle> handles;
+        std::vector<double> keys;
+        std::vector<bool> alive;
+
+        TraceOperation t;
+        t.op = 's'; t.id = 0; t.key = 0.0;
+        trace.push_back(t);
+
+        // the start node
+        t.op = 'a'; t.id = 0; t.key = 0.0;
+        trace.push_back(t);
+        handles.push_back(queue.Add(0, 0.0));
+        keys.push_back(0.0);
+        alive.push_back(true);
+
+        for (unsigned int i = 0; i < expansions && !queue.isEmpty(); ++i) {
+
+            t.op = 'p'; t.id = 0; t.key = 0.0;
+            trace.push_back(t);
+
+            unsigned int n = queue.DeleteMin();
+            alive[n] = false;
+
+            // the children
+            for (unsigned int c = 0; c < 6; ++c) {
+
+                if (0.2 > coin(gen) && 1 < keys.size()) {
+
+                    // decrease the key of a random recent node
+                    unsigned int id = keys.size() - 1 - (gen() % std::min<size_t>(keys.size() - 1, 64));
+                    double key = std::max(keys[n], keys[id] - step(gen) * 0.25);
+
+                    if (alive[id] && key < keys[id]) {
+
+                        t.op = 'd'; t.id = id; t.key = key;
+                        trace.push_back(t);
+                        queue.DecreaseKey(handles[id], key);
+                        keys[id] = key;
+
+                    }
+
+                } else {
+
+                    // a new node
+                    t.op = 'a'; t.id = keys.size(); t.key = keys[n] + step(gen);
+                    trace.push_back(t);
+                    handles.push_back(queue.Add(t.id, t.key));
+                    keys.push_back(t.key);
+                    alive.push_back(true);
+
+                }
+
+            }
+
+        }
+
+        // drain the queue
+        while (!queue.isEmpty()) {
+
+            t.op = 'p'; t.id = 0; t.key = 0.0;
+            trace.push_back(t);
+            queue.DeleteMin();
+
+        }
+
+    }
+
+}
+
+// replay a trace with a given priority queue type
+template<typename Queue>
+void ReplayTrace(const std::string &name, const std::vector<TraceOperation> &trace) {
+
+    Queue queue(UINT_MAX);
+    std::vector<typename Queue::Handle> handles;
+    std::vector<bool> alive;
+
+    // a checksum over the extracted keys order
+    double checksum = 0.0;
+    std::vector<double> keys;
+    unsigned long long pops = 0;
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    for (std::vector<TraceOperation>::const_iterator it = trace.begin(); it != trace.end(); ++it) {
+
+        switch (it->op) {
+
+            case 's':
+
+                queue.ClearHeap();
+                handles.clear();
+                alive.clear();
+                keys.clear();
+                break;
+
+            case 'a':
+
+                if (handles.size() <= it->id) {
+
+                    handles.resize(it->id + 1);
+                    alive.resize(it->id + 1, false);
+                    keys.resize(it->id + 1, 0.0);
+
+                }
+
+                handles[it->id] = queue.Add(it->id, it->key);
+                alive[it->id] = true;
+                keys[it->id] = it->key;
+                break;
+
+            case 'd':
+
+                // the node could be already extracted with a different tie breaking
+                if (it->id < alive.size() && alive[it->id]) {
+
+                    queue.DecreaseKey(handles[it->id], it->key);
+                    keys[it->id] = it->key;
+
+                }
+                break;
+
+            case 'p':
+
+                if (!queue.isEmpty()) {
+
+                    unsigned int id = queue.DeleteMin();
+                    alive[id] = false;
+                    checksum += keys[id] * (double) (++pops % 7);
+
+                }
+                break;
+
+        }
+
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    std::cout << "    " << name << ": " << elapsed.count() * 1000.0 << " ms, " << pops << " extractions, checksum " << checksum << std::endl;
+
+}
+
+// compare the open set policies over a recorded trace or a synthetic one
+void OpenSetBenchmark(int argc, char **argv) {
+
+    std::vector<TraceOperation> trace;
+
+    if (1 < argc) {
+
+        if (!LoadTrace(argv[1], trace)) {
+
+            std::cout << "Could not open the trace file: " << argv[1] << std::endl;
+            return;
+
+        }
+
+        std::cout << std::endl << "Replaying the recorded trace " << argv[1] << ": " << trace.size() << " operations" << std::endl;
+
+    } else {
+
+        SyntheticTrace(20, 50000, trace);
+
+        std::cout << std::endl << "Replaying a synthetic trace: " << trace.size() << " operations" << std::endl;
+
+    }
+
+    ReplayTrace<astar::PriorityQueue<unsigned int>>("fibonacci heap", trace);
+    ReplayTrace<astar::DaryHeap<unsigned int, 2>>("binary heap", trace);
+    ReplayTrace<astar::DaryHeap<unsigned int, 4>>("4-ary heap", trace);
+    ReplayTrace<astar::DaryHeap<unsigned int, 8>>("8-ary heap", trace);
+    ReplayTrace<astar::RadixHeap<unsigned int>>("radix heap", trace);
+
+}
+
+int main(int argc, char **argv) {
 
     // the default vector
     std::vector<int> numbers;
@@ -81,6 +350,9 @@ int main() {
     std::cout << std::endl << "Destroyed!" << std::endl;
     std::cout << std::endl << "Lets see the priority queue: " << priority_queue.GetN() << std::endl;
 
+    // the open set benchmark, pass an open_set_trace.txt file to replay a recorded HybridAstar search
+    OpenSetBenchmark(argc, argv);
+
     std::cout << "Hello, world!" << std::endl;
    return 0;
 
@@ -35,62 +35,38 @@ using namespace astar;
 // solve the current start to goal pathfinding
 ReedsSheppActionSetPtr ReedsSheppModel::Solve(const Pose2D &start, const Pose2D &goal, double unit)
 {
-    // Translate the goal so that the start position is at the origin
-    Vector2D<double> position((goal.position.x - start.position.x)/unit, (goal.position.y - start.position.y)/unit);
-
-    // Rotate the goal so that the start orientation is 0
-    position.RotateZ(-start.orientation);
-
-    // get the angle difference
-    double orientation = mrpt::math::wrapToPi<double>(goal.orientation - start.orientation);
-
-    // the sin of the orientation
-    double sin_orientation = std::sin(orientation);
-
-    // the cos of the orientation
-    double cos_orientation = std::cos(orientation);
-
-    // assuming the infinity as the min length
-    double bestPathLength = std::numeric_limits<double>::max();
-
-    // maybe the next best path length, let's see
-    double potentialLength;
-
-    // define the length helpers
-    double t = 0.0, u = 0.0, v = 0.0, t_, u_, v_;
-
-    // what is the best path word?
-    PathWords bestWord = static_cast<PathWords>(0), word;
+    // the best path word and its lengths
+    PathWords bestWord = static_cast<PathWords>(0);
+    double t = 0.0, u = 0.0, v = 0.0;
 
-    // iterating over the PathWords
-    for (unsigned int w = 0; w < NumPathWords; w++)
+    if (std::numeric_limits<double>::max() == FindBestWord(start, goal, unit, 1.0, 0.0, bestWord, t, u, v))
     {
-        // get the RS word
-        word = static_cast<PathWords>(w);
-
-        // maybe the new best path length, who knows?
-        potentialLength = GetPathLength(word, position.x, position.y, orientation, sin_orientation, cos_orientation, t_, u_, v_);
-
-        if (potentialLength < bestPathLength)
-        {
-            bestPathLength = potentialLength;
+        return new ReedsSheppActionSet(std::numeric_limits<double>::max());
+    }
 
-            bestWord = word;
+    return BuildPath(bestWord, t, u, v);
+}
 
-            t = t_;
+// get the optimal weighted cost without building the action set
+double ReedsSheppModel::Distance(const Pose2D &start, const Pose2D &goal, double radius, double reverse_factor, double gear_cost)
+{
+    // the best path word and its lengths
+    PathWords bestWord;
+    double t, u, v;
 
-            u = u_;
+    // the best cost in turning radius units, the gear switch cost is scaled down too
+    double cost = FindBestWord(start, goal, radius, reverse_factor, gear_cost / radius, bestWord, t, u, v);
 
-            v = v_;
-        }
-    }
+    return std::numeric_limits<double>::max() == cost ? cost : cost * radius;
+}
 
-    if (std::numeric_limits<double>::max() == bestPathLength)
+// the batch version, the costs from a list of start poses to the same goal
+void ReedsSheppModel::Distance(const Pose2D *starts, unsigned int n, const Pose2D &goal, double radius, double reverse_factor, double gear_cost, double *costs)
+{
+    for (unsigned int i = 0; i < n; ++i)
     {
-        return new ReedsSheppActionSet(std::numeric_limits<double>::max());
+        costs[i] = Distance(starts[i], goal, radius, reverse_factor, gear_cost);
     }
-
-    return BuildPath(bestWord, t, u, v);
 }
 
 // return a list of poses from a given action set
@@ -490,99 +466,240 @@ StateArrayPtr ReedsSheppModel::Discretize_LR(
 }
 
 // PRIVATE METHODS
+// wrap an angle to [0, 2PI), the word families only produce angles inside (-2PI, 4PI)
+// inside this range it's the same result as the mrpt version, but there's no fmod call
+inline double ReedsSheppModel::WrapTo2Pi(double a)
+{
+    // the exact 2PI double value
+    const double two_pi = 2.0 * M_PI;
+
+    if (0.0 <= a)
+    {
+        if (two_pi > a) return a;
+
+        // exact, a is inside [2PI, 4PI)
+        if (2.0 * two_pi > a) return a - two_pi;
+    }
+    else if (-two_pi < a)
+    {
+        return a + two_pi;
+    }
+
+    return mrpt::math::wrapTo2Pi<double>(a);
+}
+
+// wrap an angle to ]-PI, PI], the same as the mrpt version
+inline double ReedsSheppModel::WrapToPi(double a)
+{
+    return WrapTo2Pi(a + M_PI) - M_PI;
+}
+
 // invalid angle test
 bool ReedsSheppModel::isInvalidAngle(double angle)
 {
     return angle < 0 || angle > M_PI;
 }
 
-// calculate the optimal path length
-double ReedsSheppModel::GetPathLength(PathWords w, double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+// the word families in the PathWords order
+// each family is evaluated over the four symmetries: identity, time flip, reflect and time flip + reflect
+// the segments follow the Get*path builders, so the weighted cost matches the built action set
+const ReedsSheppModel::WordFamily ReedsSheppModel::families[ReedsSheppModel::NumPathWords / 4] =
 {
-    // the current path length
-    double len;
+    // Reeds-Shepp 8.1: CSC, same turn
+    { &ReedsSheppModel::GetLfSfLf, false, 3,
+      { { SegmentT, ForwardGear }, { SegmentU, ForwardGear }, { SegmentV, ForwardGear } } },
+
+    // Reeds-Shepp 8.2: CSC, different turn
+    { &ReedsSheppModel::GetLfSfRf, true, 3,
+      { { SegmentT, ForwardGear }, { SegmentU, ForwardGear }, { SegmentV, ForwardGear } } },
+
+    // Reeds-Shepp 8.3: C|C|C
+    { &ReedsSheppModel::GetLfRbLf, false, 3,
+      { { SegmentT, ForwardGear }, { SegmentU, BackwardGear }, { SegmentV, ForwardGear } } },
 
-    switch (w)
+    // Reeds-Shepp 8.4: C|CC
+    { &ReedsSheppModel::GetLfRbLb, false, 3,
+      { { SegmentT, ForwardGear }, { SegmentU, BackwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.4: CC|C
+    { &ReedsSheppModel::GetLfRfLb, false, 3,
+      { { SegmentT, ForwardGear }, { SegmentU, ForwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.7: CCu|CuC
+    { &ReedsSheppModel::GetLfRufLubRb, true, 4,
+      { { SegmentT, ForwardGear }, { SegmentU, ForwardGear }, { SegmentU, BackwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.8: C|CuCu|C
+    { &ReedsSheppModel::GetLfRubLubRf, true, 4,
+      { { SegmentT, ForwardGear }, { SegmentU, BackwardGear }, { SegmentU, BackwardGear }, { SegmentV, ForwardGear } } },
+
+    // Reeds-Shepp 8.9: C|C(pi/2)SC, same turn
+    { &ReedsSheppModel::GetLfRbpi2SbLb, false, 4,
+      { { SegmentT, ForwardGear }, { SegmentPi2, BackwardGear }, { SegmentU, BackwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.10: C|C(pi/2)SC, different turn
+    { &ReedsSheppModel::GetLfRbpi2SbRb, true, 4,
+      { { SegmentT, ForwardGear }, { SegmentPi2, BackwardGear }, { SegmentU, BackwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.9 (reversed): CSC(pi/2)|C, same turn
+    { &ReedsSheppModel::GetLfSfRfpi2Lb, false, 4,
+      { { SegmentT, ForwardGear }, { SegmentU, ForwardGear }, { SegmentPi2, ForwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.10 (reversed): CSC(pi/2)|C, different turn
+    { &ReedsSheppModel::GetLfSfLfpi2Rb, true, 4,
+      { { SegmentT, ForwardGear }, { SegmentU, ForwardGear }, { SegmentPi2, ForwardGear }, { SegmentV, BackwardGear } } },
+
+    // Reeds-Shepp 8.11: C|C(pi/2)SC(pi/2)|C
+    { &ReedsSheppModel::GetLfRbpi2SbLbpi2Rf, true, 5,
+      { { SegmentT, ForwardGear }, { SegmentPi2, BackwardGear }, { SegmentU, BackwardGear }, { SegmentPi2, BackwardGear }, { SegmentV, ForwardGear } } }
+};
+
+// the weighted cost of a word, in turning radius units
+double ReedsSheppModel::WordCost(const WordFamily &family, bool time_flip, double t, double u, double v, double reverse_factor, double gear_cost)
+{
+    // the segment lengths, indexed by the SegmentLength values
+    const double lengths[4] = { t, u, v, M_PI_2 };
+
+    // the time flip inverts all the gears
+    Gear flip = time_flip ? BackwardGear : ForwardGear;
+
+    // the first gear
+    Gear prevGear = static_cast<Gear>(family.segments[0].gear ^ flip);
+
+    // the final cost
+    double cost = 0.0;
+
+    for (unsigned int i = 0; i < family.size; ++i)
     {
-        // Reeds-Shepp 8.1: CSC, same turn
-        case LfSfLf: { len = GetLfSfLf(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbSbLb: { len = GetLfSfLf(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfSfRf: { len = GetLfSfLf(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbSbRb: { len = GetLfSfLf(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        // the current segment
+        const WordSegment &segment(family.segments[i]);
 
-        // Reeds-Shepp 8.2: CSC, different turn
-        case LfSfRf: { len = GetLfSfRf(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbSbRb: { len = GetLfSfRf(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfSfLf: { len = GetLfSfRf(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbSbLb: { len = GetLfSfRf(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        Gear gear = static_cast<Gear>(segment.gear ^ flip);
 
-        // Reeds-Shepp 8.3: C|C|C
-        case LfRbLf: { len = GetLfRbLf(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRfLb: { len = GetLfRbLf(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLbRf: { len = GetLfRbLf(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLfRb: { len = GetLfRbLf(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        // get the current segment cost
+        double segmentCost = lengths[segment.length];
 
-        // Reeds-Shepp 8.4: C|CC
-        case LfRbLb: { len = GetLfRbLb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRfLf: { len = GetLfRbLb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLbRb: { len = GetLfRbLb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLfRf: { len = GetLfRbLb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        if (BackwardGear == gear)
+        {
+            // multiply by the reverse cost
+            segmentCost *= reverse_factor;
+        }
 
-        // Reeds-Shepp 8.4: CC|C
-        case LfRfLb: { len = GetLfRfLb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRbLf: { len = GetLfRfLb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLfRb: { len = GetLfRfLb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLbRf: { len = GetLfRfLb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        if (prevGear != gear)
+        {
+            // add the gear switch cost
+            segmentCost += gear_cost;
+        }
 
-        // Reeds-Shepp 8.7: CCu|CuC
-        case LfRufLubRb: { len = GetLfRufLubRb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRubLufRf: { len = GetLfRufLubRb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLufRubLb: { len = GetLfRufLubRb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLubRufLf: { len = GetLfRufLubRb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        // update the prevGear to the current gear
+        prevGear = gear;
 
-        // Reeds-Shepp 8.8: C|CuCu|C
-        case LfRubLubRf: { len = GetLfRubLubRf(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRufLufRb: { len = GetLfRubLubRf(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLubRubLf: { len = GetLfRubLubRf(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLufRufLb: { len = GetLfRubLubRf(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+        cost += segmentCost;
+    }
 
-        // Reeds-Shepp 8.9: C|C(pi/2)SC, same turn
-        case LfRbpi2SbLb: { len = GetLfRbpi2SbLb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRfpi2SfLf: { len = GetLfRbpi2SbLb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLbpi2SbRb: { len = GetLfRbpi2SbLb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLfpi2SfRf: { len = GetLfRbpi2SbLb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+    return cost;
+}
 
-        // Reeds-Shepp 8.10: C|C(pi/2)SC, different turn
-        case LfRbpi2SbRb: { len = GetLfRbpi2SbLb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRfpi2SfRf: { len = GetLfRbpi2SbLb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLbpi2SbLb: { len = GetLfRbpi2SbLb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLfpi2SfLf: { len = GetLfRbpi2SbLb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+// find the cheapest path word, returns the weighted cost in turning radius units
+double ReedsSheppModel::FindBestWord(const Pose2D &start, const Pose2D &goal, double unit, double reverse_factor, double gear_cost, PathWords &best, double &t, double &u, double &v)
+{
+    // the plain length is the cost, the word costs are skipped
+    bool weighted = 1.0 != reverse_factor || 0.0 != gear_cost;
 
-        // Reeds-Shepp 8.9 (reversed): CSC(pi/2)|C, same turn
-        case LfSfRfpi2Lb: { len = GetLfSfRfpi2Lb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbSbRbpi2Lf: { len = GetLfSfRfpi2Lb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfSfLfpi2Rb: { len = GetLfSfRfpi2Lb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbSbLbpi2Rf: { len = GetLfSfRfpi2Lb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+    // Translate the goal so that the start position is at the origin
+    Vector2D<double> position((goal.position.x - start.position.x)/unit, (goal.position.y - start.position.y)/unit);
 
-        // Reeds-Shepp 8.10 (reversed): CSC(pi/2)|C, different turn
-        case LfSfLfpi2Rb: { len = GetLfSfLfpi2Rb(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbSbLbpi2Rf: { len = GetLfSfLfpi2Rb(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfSfRfpi2Lb: { len = GetLfSfLfpi2Rb(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbSbRbpi2Lf: { len = GetLfSfLfpi2Rb(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
+    // Rotate the goal so that the start orientation is 0
+    position.RotateZ(-start.orientation);
 
-        // Reeds-Shepp 8.11: C|C(pi/2)SC(pi/2)|C
-        case LfRbpi2SbLbpi2Rf: { len = GetLfRbpi2SbLbpi2Rf(goal_x, goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        case LbRfpi2SfLfpi2Rb: { len = GetLfRbpi2SbLbpi2Rf(-goal_x, goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RfLbpi2SbRbpi2Lf: { len = GetLfRbpi2SbLbpi2Rf(goal_x, -goal_y, -goal_orientation, -sin_o, cos_o, t, u, v); break; }
-        case RbLfpi2SfRfpi2Lb: { len = GetLfRbpi2SbLbpi2Rf(-goal_x, -goal_y, goal_orientation, sin_o, cos_o, t, u, v); break; }
-        default:
-            // set to the default value
-            len = std::numeric_limits<double>::infinity();
-            break;
+    // get the angle difference
+    double orientation = mrpt::math::wrapToPi<double>(goal.orientation - start.orientation);
+
+    // the sin of the orientation
+    double sin_orientation = std::sin(orientation);
+
+    // the cos of the orientation
+    double cos_orientation = std::cos(orientation);
+
+    // the symmetry signs: identity, time flip, reflect and time flip + reflect
+    // the orientation and its sin share the same sign
+    const double sign_x[4] = { 1.0, -1.0, 1.0, -1.0 };
+    const double sign_y[4] = { 1.0, 1.0, -1.0, -1.0 };
+    const double sign_o[4] = { 1.0, -1.0, -1.0, 1.0 };
+
+    // the goal orientation of each symmetry
+    double orientations[4];
+
+    // the left and right turning circles of each symmetry, in a flat array
+    // the first four are the left circles (x - sin, y - 1 + cos), the last four are the right ones (x + sin, y - 1 - cos)
+    CircleTerms circles[8];
+
+    for (unsigned int s = 0; s < 4; ++s)
+    {
+        // the symmetric goal
+        double x = sign_x[s] * position.x;
+        double y = sign_y[s] * position.y;
+        double sin_o = sign_o[s] * sin_orientation;
+
+        orientations[s] = sign_o[s] * orientation;
+
+        circles[s].x = x - sin_o;
+        circles[s].eta = y - 1 + cos_orientation;
+
+        circles[s + 4].x = x + sin_o;
+        circles[s + 4].eta = y - 1 - cos_orientation;
+    }
+
+    // the polar terms, computed once and shared by all the word families
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        circles[i].r2 = circles[i].x * circles[i].x + circles[i].eta * circles[i].eta;
+        circles[i].r = std::sqrt(circles[i].r2);
+        circles[i].phi = std::atan2(circles[i].eta, circles[i].x);
+    }
+
+    // assuming the infinity as the min length
+    double bestPathLength = std::numeric_limits<double>::max();
+
+    // the length helpers
+    double t_, u_, v_;
+
+    // iterating over the PathWords, the ties keep the first word
+    for (unsigned int f = 0, w = 0; f < NumPathWords / 4; ++f)
+    {
+        // the current family
+        const WordFamily &family(families[f]);
+
+        // the family circles
+        const CircleTerms *family_circles = family.right ? circles + 4 : circles;
+
+        for (unsigned int s = 0; s < 4; ++s, ++w)
+        {
+            // maybe the new best path length, who knows?
+            double potentialLength = (*family.length)(family_circles[s], orientations[s], t_, u_, v_);
+
+            if (weighted && std::numeric_limits<double>::max() != potentialLength)
+            {
+                // the odd symmetries are the time flipped ones
+                potentialLength = WordCost(family, 1 == (s & 1), t_, u_, v_, reverse_factor, gear_cost);
+            }
+
+            if (potentialLength < bestPathLength)
+            {
+                bestPathLength = potentialLength;
+
+                best = static_cast<PathWords>(w);
+
+                t = t_;
+
+                u = u_;
+
+                v = v_;
+            }
+        }
     }
 
-    // return the desired len
-    return len;
+    return bestPathLength;
 }
 
 // build the Reeds-Shepp path
@@ -640,10 +757,10 @@ ReedsSheppActionSetPtr ReedsSheppModel::BuildPath(PathWords w, double t, double
         case RbLfpi2SfRf: return ReedsSheppActionSet::TimeFlipAndReflect(GetLfRbpi2SbLbpath(t, u, v));
 
         // Reeds-Shepp 8.10: C|C(pi/2)SC, different turn
-        case LfRbpi2SbRb: return GetLfRbpi2SbLbpath(t, u, v);
-        case LbRfpi2SfRf: return ReedsSheppActionSet::TimeFlip(GetLfRbpi2SbLbpath(t, u, v));
-        case RfLbpi2SbLb: return ReedsSheppActionSet::Reflect(GetLfRbpi2SbLbpath(t, u, v));
-        case RbLfpi2SfLf: return ReedsSheppActionSet::TimeFlipAndReflect(GetLfRbpi2SbLbpath(t, u, v));
+        case LfRbpi2SbRb: return GetLfRbpi2SbRbpath(t, u, v);
+        case LbRfpi2SfRf: return ReedsSheppActionSet::TimeFlip(GetLfRbpi2SbRbpath(t, u, v));
+        case RfLbpi2SbLb: return ReedsSheppActionSet::Reflect(GetLfRbpi2SbRbpath(t, u, v));
+        case RbLfpi2SfLf: return ReedsSheppActionSet::TimeFlipAndReflect(GetLfRbpi2SbRbpath(t, u, v));
 
         // Reeds-Shepp 8.9 (reversed): CSC(pi/2)|C, same turn
         case LfSfRfpi2Lb: return GetLfSfRfpi2Lbpath(t, u, v);
@@ -668,23 +785,19 @@ ReedsSheppActionSetPtr ReedsSheppModel::BuildPath(PathWords w, double t, double
 }
 
 // left forward, straight forward and left forward movement - get the path length
-double ReedsSheppModel::GetLfSfLf(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfSfLf(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.1
     // C_C_C
 
-    // get the x and y parameters
-    double x = goal_x - sin_o;
-    double y = goal_y - 1 + cos_o;
-
     // update the t value
-    t = std::atan2(y, x);
+    t = c.phi;
 
     // update the u value
-    u = std::sqrt(x*x + y*y);
+    u = c.r;
 
     // update the v value
-    v = mrpt::math::wrapToPi<double>(goal_orientation - t);
+    v = WrapToPi(goal_orientation - t);
 
     if (isInvalidAngle(t) || isInvalidAngle(v))
     {
@@ -715,33 +828,26 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfSfLfpath(double t, double u, double
 }
 
 // left forward, straight forward and right forward movement - get the path length
-double ReedsSheppModel::GetLfSfRf(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfSfRf(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.2
 
-    // get the x and y parameters
-    double x = goal_x + sin_o;
-    double y = goal_y - 1 - cos_o;
-
-    double u1squared = x * x + y * y;
-    double t1 = std::atan2(y, x);
-
-    if (4 > u1squared)
+    if (4 > c.r2)
     {
         return std::numeric_limits<double>::max();
     }
 
     // update the u value
-    u = std::sqrt(u1squared - 4);
+    u = std::sqrt(c.r2 - 4);
 
     // get the phi value
     double phi = std::atan2(2.0, (u));
 
     // update the t value
-    t = mrpt::math::wrapToPi<double>(t1 + phi);
+    t = WrapToPi(c.phi + phi);
 
     // update the v value
-    v = mrpt::math::wrapToPi<double>(t - goal_orientation);
+    v = WrapToPi(t - goal_orientation);
 
     if (isInvalidAngle(t) || isInvalidAngle(v))
     {
@@ -770,32 +876,27 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfSfRfpath(double t, double u, double
 }
 
 // left forward, right backward and left forward movement - get the path length
-double ReedsSheppModel::GetLfRbLf(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRbLf(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.3
     // Uses a modified formula adapted from the c_c_c function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x - sin_o;
-    double eta = goal_y - 1 + cos_o;
-
-    double u1 = std::sqrt(x * x + eta * eta);
-    if (4 < u1)
+    if (4 < c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-    double alpha = std::acos(u1 / 4);
+    double alpha = std::acos(c.r / 4);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + alpha + phi);
+    t = WrapTo2Pi(M_PI_2 + alpha + c.phi);
 
     // update the u value
-    u = mrpt::math::wrapTo2Pi<double>(M_PI - 2 * alpha);
+    u = WrapTo2Pi(M_PI - 2 * alpha);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(goal_orientation - t - u);
+    v = WrapTo2Pi(goal_orientation - t - u);
 
     if (isInvalidAngle(t) || isInvalidAngle(u) || isInvalidAngle(v))
     {
@@ -824,32 +925,27 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRbLfpath(double t, double u, double
 }
 
 // left forward, right backward and left backward movement - get the path length
-double ReedsSheppModel::GetLfRbLb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRbLb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.4
     // Uses a modified formula adapted from the c_cc function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x - sin_o;
-    double eta = goal_y - 1 + cos_o;
-
-    double u1 = std::sqrt(x * x + eta * eta);
-    if (4 < u1)
+    if (4 < c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-    double alpha = std::acos(u1 / 4);
+    double alpha = std::acos(c.r / 4);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + alpha + phi);
+    t = WrapTo2Pi(M_PI_2 + alpha + c.phi);
 
     // update the u value
-    u = mrpt::math::wrapTo2Pi<double>(M_PI - 2 * alpha);
+    u = WrapTo2Pi(M_PI - 2 * alpha);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(t + u - goal_orientation);
+    v = WrapTo2Pi(t + u - goal_orientation);
 
     return t + u + v;
 }
@@ -873,34 +969,29 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRbLbpath(double t, double u, double
 }
 
 // left forward, right forward and left backward movement - get the path length
-double ReedsSheppModel::GetLfRfLb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
-{    // Reeds-Shepp 8.4
+double ReedsSheppModel::GetLfRfLb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
+{
+    // Reeds-Shepp 8.4
     // Uses a modified formula adapted from the cc_c function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x - sin_o;
-    double eta = goal_y - 1 + cos_o;
-
-    double u1 = std::sqrt(x * x + eta * eta);
-    if (4 < u1)
+    if (4 < c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
     // update the u value
-    u = std::acos((8.0 - u1 * u1) / 8.0);
+    u = std::acos((8.0 - c.r * c.r) / 8.0);
 
     double va = std::sin(u);
 
-    double alpha = std::asin(2 * va / u1);
+    double alpha = std::asin(2 * va / c.r);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 - alpha + phi);
+    t = WrapTo2Pi(M_PI_2 - alpha + c.phi);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(t - u - goal_orientation);
+    v = WrapTo2Pi(t - u - goal_orientation);
 
     return t + u + v;
 }
@@ -924,48 +1015,42 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRfLbpath(double t, double u, double
 }
 
 // left forward, right forward, left backward and right forward movement - get the path length
-double ReedsSheppModel::GetLfRufLubRb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRufLubRb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.7
     // Uses a modified formula adapted from the ccu_cuc function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x + sin_o;
-    double eta = goal_y - 1 - cos_o;
-
-    double u1 = std::sqrt(x*x + eta * eta);
-    if (4 < u1)
+    if (4 < c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
-    if (u1 > 2)
+    if (c.r > 2)
     {
-        double alpha = std::acos(u1 / 4 - 0.5);
+        double alpha = std::acos(c.r / 4 - 0.5);
 
         // update the t value
-        t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi - alpha);
+        t = WrapTo2Pi(M_PI_2 + c.phi - alpha);
 
         // update the u value
-        u = mrpt::math::wrapTo2Pi<double>(M_PI - alpha);
+        u = WrapTo2Pi(M_PI - alpha);
 
         // update the v value
-        v = mrpt::math::wrapTo2Pi<double>(goal_orientation - t + 2 * (u));
+        v = WrapTo2Pi(goal_orientation - t + 2 * (u));
     }
     else
     {
-        double alpha = std::acos(u1 / 4 + 0.5);
+        double alpha = std::acos(c.r / 4 + 0.5);
 
         // update the t value
-        t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi + alpha);
+        t = WrapTo2Pi(M_PI_2 + c.phi + alpha);
 
         // update the u value
-        u = mrpt::math::wrapTo2Pi<double>(alpha);
+        u = WrapTo2Pi(alpha);
 
         // update the v value
-        v = mrpt::math::wrapTo2Pi<double>(goal_orientation - t + 2 * (u));
+        v = WrapTo2Pi(goal_orientation - t + 2 * (u));
     }
 
     return t + u + u + v;
@@ -993,23 +1078,19 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRufLubRbpath(double t, double u, do
 }
 
 // left forward, right backward, left backward and right forward movement - get the path length
-double ReedsSheppModel::GetLfRubLubRf(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRubLubRf(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.8
     // Uses a modified formula adapted from the c_cucu_c function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x + sin_o;
-    double eta = goal_y - 1 - cos_o;
-
-    double u1 = std::sqrt(x * x + eta * eta);
-    if (6 < u1)
+    if (6 < c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-    double va1 = 1.25f - u1 * u1 / 16;
+    double va1 = 1.25f - c.r * c.r / 16;
+
     if (va1 < 0 || va1 > 1.0)
     {
         return std::numeric_limits<double>::max();
@@ -1017,14 +1098,16 @@ double ReedsSheppModel::GetLfRubLubRf(double goal_x, double goal_y, double goal_
 
     // update the u value
     u = std::acos(va1);
+
     double va2 = std::sin(u);
-    double alpha = std::asin(2 * va2 / u1);
+
+    double alpha = std::asin(2 * va2 / c.r);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi + alpha);
+    t = WrapTo2Pi(M_PI_2 + c.phi + alpha);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(t - goal_orientation);
+    v = WrapTo2Pi(t - goal_orientation);
 
     return t + u + u + v;
 }
@@ -1051,25 +1134,20 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRubLubRfpath(double t, double u, do
 }
 
 // left forward, right backward PI over 2, straight backward and left backward movement - get the path length
-double ReedsSheppModel::GetLfRbpi2SbLb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRbpi2SbLb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.9
     // Uses a modified formula adapted from the c_c2sca function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x - sin_o;
-    double eta = goal_y - 1 + cos_o;
-
-    double u1squared = x * x + eta * eta;
-    if (u1squared < 4)
+    if (c.r2 < 4)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
     // update the u value
-    u = std::sqrt(u1squared - 4) - 2;
+    u = std::sqrt(c.r2 - 4) - 2;
+
     if (0 > u)
     {
         return std::numeric_limits<double>::max();
@@ -1078,10 +1156,10 @@ double ReedsSheppModel::GetLfRbpi2SbLb(double goal_x, double goal_y, double goal
     double alpha = std::atan2(2, (u) + 2);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi + alpha);
+    t = WrapTo2Pi(M_PI_2 + c.phi + alpha);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(t + M_PI_2 - goal_orientation);
+    v = WrapTo2Pi(t + M_PI_2 - goal_orientation);
 
     return t + M_PI_2 + u + v;
 }
@@ -1108,31 +1186,25 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRbpi2SbLbpath(double t, double u, d
 }
 
 // left forward, right backward PI over 2, straight backward and right backward movement - get the path length
-double ReedsSheppModel::GetLfRbpi2SbRb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRbpi2SbRb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.10
     // Uses a modified formula adapted from the c_c2scb function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x + sin_o;
-    double eta = goal_y - 1 - cos_o;
-
-    double u1 = std::sqrt(x*x + eta*eta);
-    if (2.0 > u1)
+    if (2.0 > c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi);
+    t = WrapTo2Pi(M_PI_2 + c.phi);
 
     // update the u value
-    u = u1 - 2;
+    u = c.r - 2;
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(goal_orientation - t - M_PI_2);
+    v = WrapTo2Pi(goal_orientation - t - M_PI_2);
 
     return t + M_PI_2 + u + v;
 }
@@ -1159,25 +1231,20 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfRbpi2SbRbpath(double t, double u, d
 }
 
 // left forward, straight forward, right forward PI over 2 and right backward movement - get the path length
-double ReedsSheppModel::GetLfSfRfpi2Lb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfSfRfpi2Lb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.9 (reversed)
     // Uses a modified formula adapted from the csc2_ca function
-//     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
-
-    double x = goal_x - sin_o;
-    double eta = goal_y - 1 + cos_o;
+    // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double u1squared = x*x + eta*eta;
-    if (4 > u1squared)
+    if (4 > c.r2)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
     // update the u value
-    u = std::sqrt(u1squared - 4) - 2;
+    u = std::sqrt(c.r2 - 4) - 2;
+
     if (0 > (u))
     {
         return std::numeric_limits<double>::max();
@@ -1186,10 +1253,10 @@ double ReedsSheppModel::GetLfSfRfpi2Lb(double goal_x, double goal_y, double goal
     double alpha = std::atan2((u) + 2, 2);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi - alpha);
+    t = WrapTo2Pi(M_PI_2 + c.phi - alpha);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(t - M_PI_2 - goal_orientation);
+    v = WrapTo2Pi(t - M_PI_2 - goal_orientation);
 
     return t + u + M_PI_2 + v;
 }
@@ -1216,31 +1283,25 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfSfRfpi2Lbpath(double t, double u, d
 }
 
 // left forward, straight forward, left forward PI over 2 and right backward movement - get the path length
-double ReedsSheppModel::GetLfSfLfpi2Rb(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfSfLfpi2Rb(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.10 (reversed)
     // Uses a modified formula adapted from the csc2_cb function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x + sin_o;
-    double eta = goal_y - 1 - cos_o;
-
-    double u1 = std::sqrt(x*x + eta * eta);
-    if (2.0 > u1)
+    if (2.0 > c.r)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(phi);
+    t = WrapTo2Pi(c.phi);
 
     // update the u value
-    u = u1 - 2;
+    u = c.r - 2;
 
     // update the t value
-    v = mrpt::math::wrapTo2Pi<double>(-t - M_PI_2 + goal_orientation);
+    v = WrapTo2Pi(-t - M_PI_2 + goal_orientation);
 
     return t + u + M_PI_2 + v;
 }
@@ -1267,25 +1328,20 @@ ReedsSheppActionSetPtr ReedsSheppModel::GetLfSfLfpi2Rbpath(double t, double u, d
 }
 
 // left forward, right backward PI over 2, straight backward, left backward PI over 2 and right forward movement - get the path length
-double ReedsSheppModel::GetLfRbpi2SbLbpi2Rf(double goal_x, double goal_y, double goal_orientation, double sin_o, double cos_o, double &t, double &u, double &v)
+double ReedsSheppModel::GetLfRbpi2SbLbpi2Rf(const CircleTerms &c, double goal_orientation, double &t, double &u, double &v)
 {
     // Reeds-Shepp 8.11
     // Uses a modified formula adapted from the c_c2sc2_c function
     // from http://msl.cs.uiuc.edu/~lavalle/cs326a/rs.c
 
-    double x = goal_x + sin_o;
-    double eta = goal_y - 1 - cos_o;
-
-    double u1squared = x * x + eta * eta;
-    if (16 > u1squared)
+    if (16 > c.r2)
     {
         return std::numeric_limits<double>::max();
     }
 
-    double phi = std::atan2(eta, x);
-
     // update the u value
-    u = std::sqrt(u1squared - 4) - 4;
+    u = std::sqrt(c.r2 - 4) - 4;
+
     if (0 > (u))
     {
         return std::numeric_limits<double>::max();
@@ -1294,10 +1350,10 @@ double ReedsSheppModel::GetLfRbpi2SbLbpi2Rf(double goal_x, double goal_y, double
     double alpha = std::atan2(2, (u) + 4);
 
     // update the t value
-    t = mrpt::math::wrapTo2Pi<double>(M_PI_2 + phi + alpha);
+    t = WrapTo2Pi(M_PI_2 + c.phi + alpha);
 
     // update the v value
-    v = mrpt::math::wrapTo2Pi<double>(t - goal_orientation);
+    v = WrapTo2Pi(t - goal_orientation);
 
     return t + u + v + M_PI;
 }
@@ -120,88 +120,154 @@ namespace astar {
     {
         private:
 
+            // the polar terms of a turning circle center, relative to the goal
+            // all the word families of a given symmetry use the same left or right circle
+            class CircleTerms {
+
+                public:
+
+                    // the circle center displacement
+                    double x, eta;
+
+                    // the squared distance and the distance
+                    double r2, r;
+
+                    // the polar angle
+                    double phi;
+
+            };
+
+            // the length of a word segment: one of the t, u and v values or a quarter turn
+            enum SegmentLength { SegmentT, SegmentU, SegmentV, SegmentPi2 };
+
+            // a word segment, the gear is the base word one (the time flip inverts it)
+            class WordSegment {
+
+                public:
+
+                    // the segment length
+                    SegmentLength length;
+
+                    // the segment gear
+                    Gear gear;
+
+            };
+
+            // a word family: the path length function, the turning circle it uses and the BuildPath segments
+            class WordFamily {
+
+                public:
+
+                    // the path length function
+                    double (*length)(const CircleTerms&, double, double&, double&, double&);
+
+                    // uses the right circle (x + sin, y - 1 - cos)?
+                    bool right;
+
+                    // how many segments
+                    unsigned int size;
+
+                    // the segments, in the same order as the built action set
+                    WordSegment segments[5];
+
+            };
+
             // PRIVATE ATTRIBUTES
             const static unsigned int NumPathWords = 48;
 
+            // the word families in the PathWords order
+            static const WordFamily families[NumPathWords / 4];
+
             // PRIVATE METHODS
 
+            // wrap an angle to [0, 2PI), without the fmod call inside the word families range
+            static double WrapTo2Pi(double);
+
+            // wrap an angle to ]-PI, PI]
+            static double WrapToPi(double);
+
             // invalid angle test
-            bool isInvalidAngle(double);
+            static bool isInvalidAngle(double);
 
-            // calculate the optimal path length
-            double GetPathLength(PathWords w, double, double, double, double, double, double&, double&, double&);
+            // the weighted cost of a word, in turning radius units, the same as the ReedsSheppActionSet::CalculateCost
+            // the gear switch cost must be in turning radius units too
+            static double WordCost(const WordFamily&, bool time_flip, double t, double u, double v, double reverse_factor, double gear_cost);
+
+            // find the cheapest path word, returns the weighted cost in turning radius units
+            // the unit reverse factor and the zero gear switch cost give the shortest path word and its length
+            double FindBestWord(const astar::Pose2D&, const astar::Pose2D&, double unit, double reverse_factor, double gear_cost, PathWords &best, double &t, double &u, double &v);
 
             // build the Reeds-Shepp path
             ReedsSheppActionSetPtr BuildPath(PathWords w, double, double, double);
 
             // left forward, straight forward and left forward movement - get the path length
-            double GetLfSfLf(double, double, double, double, double, double&, double&, double&);
+            static double GetLfSfLf(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfSfLf path based on given t, u and v
             ReedsSheppActionSetPtr GetLfSfLfpath(double, double, double);
 
             // left forward, straight forward and right forward movement - get the path length
-            double GetLfSfRf(double, double, double, double, double, double&, double&, double&);
+            static double GetLfSfRf(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfSfRf path based on given t, u and v
             ReedsSheppActionSetPtr GetLfSfRfpath(double, double, double);
 
             // left forward, right backward and left forward movement - get the path length
-            double GetLfRbLf(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRbLf(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRbLf path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRbLfpath(double, double, double);
 
             // left forward, right backward and left backward movement - get the path length
-            double GetLfRbLb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRbLb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRbLb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRbLbpath(double, double, double);
 
             // left forward, right forward and left backward movement - get the path length
-            double GetLfRfLb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRfLb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRfLb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRfLbpath(double, double, double);
 
             // left forward, right forward, left backward and right forward movement - get the path length
-            double GetLfRufLubRb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRufLubRb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRufLubRb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRufLubRbpath(double, double, double);
 
             // left forward, right backward, left backward and right forward movement - get the path length
-            double GetLfRubLubRf(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRubLubRf(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRubLubRf path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRubLubRfpath(double, double, double);
 
             // left forward, right backward PI over 2, straight backward and left backward movement - get the path length
-            double GetLfRbpi2SbLb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRbpi2SbLb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRbpi2SbLb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRbpi2SbLbpath(double, double, double);
 
             // left forward, right backward PI over 2, straight backward and right backward movement - get the path length
-            double GetLfRbpi2SbRb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRbpi2SbRb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRbpi2SbRb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRbpi2SbRbpath(double, double, double);
 
             // left forward, straight forward, right forward PI over 2 and right backward movement - get the path length
-            double GetLfSfRfpi2Lb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfSfRfpi2Lb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfSfRfpi2Lb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfSfRfpi2Lbpath(double, double, double);
 
             // left forward, straight forward, left forward PI over 2 and right backward movement - get the path length
-            double GetLfSfLfpi2Rb(double, double, double, double, double, double&, double&, double&);
+            static double GetLfSfLfpi2Rb(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfSfLfpi2Rb path based on given t, u and v
             ReedsSheppActionSetPtr GetLfSfLfpi2Rbpath(double, double, double);
 
             // left forward, right backward PI over 2, straight backward, left backward PI over 2 and right forward movement - get the path length
-            double GetLfRbpi2SbLbpi2Rf(double, double, double, double, double, double&, double&, double&);
+            static double GetLfRbpi2SbLbpi2Rf(const CircleTerms&, double, double&, double&, double&);
 
             // build the actual LfRbpi2SbLbpi2Rf path based on given t, u and v
             ReedsSheppActionSetPtr GetLfRbpi2SbLbpi2Rfpath(double, double, double);
@@ -215,6 +281,15 @@ namespace astar {
             // solve the current start to goal pathfinding
             astar::ReedsSheppActionSetPtr Solve(const astar::Pose2D&, const astar::Pose2D&, double);
 
+            // get the optimal weighted cost without building the action set, nothing is allocated
+            // the backward segments are multiplied by the reverse factor and each gear switch adds the gear cost,
+            // the same as the ReedsSheppActionSet::CalculateCost, the max double value if there's no path
+            double Distance(const astar::Pose2D &start, const astar::Pose2D &goal, double radius, double reverse_factor = 1.0, double gear_cost = 0.0);
+
+            // the batch version, the costs from a list of start poses to the same goal
+            // a whole heuristic table row at once, the costs array must hold n values
+            void Distance(const astar::Pose2D *starts, unsigned int n, const astar::Pose2D &goal, double radius, double reverse_factor, double gear_cost, double *costs);
+
             // return a list of poses from a given action set
             static astar::StateArrayPtr DiscretizeRS(const Pose2D&, ReedsSheppActionPtr, double, double);
 
@@ -1,6 +1,8 @@
 #include <iostream>
 
 #include <exception>
+#include <random>
+#include <cmath>
 #include "../Entities/Pose2D.hpp"
 #include "ReedsSheppModel.hpp"
 
@@ -58,6 +60,13 @@ int main ()
 
         std::cout << std::endl << "Total length: " << set->length*inverse_unit << std::endl;
 
+        // the cost only version, no action set
+        std::cout << "Distance: " << rs.Distance(start, goal, inverse_unit) << std::endl;
+
+        // the weighted cost must match the action set one
+        std::cout << "Weighted cost: " << set->CalculateCost(inverse_unit, 2.0, 1.0) << std::endl;
+        std::cout << "Weighted distance: " << rs.Distance(start, goal, inverse_unit, 2.0, 1.0) << std::endl;
+
     }
     else
     {
@@ -66,5 +75,50 @@ int main ()
 
     delete(set);
 
+    // random start poses against a goal at the origin: every path must end at the goal
+    // and the optimal length is continuous, so a 1 cm lateral move can't change it by much
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> position(-30.0, 30.0), orientation(-pi, pi);
+
+    astar::Pose2D origin(0.0, 0.0, 0.0);
+
+    unsigned int missed = 0, jumps = 0;
+    double max_jump = 0.0;
+
+    const unsigned int N = 100000;
+
+    for (unsigned int i = 0; i < N; i++)
+    {
+        astar::Pose2D s(position(generator), position(generator), orientation(generator));
+
+        astar::ReedsSheppActionSetPtr path = rs.Solve(s, origin, inverse_unit);
+        astar::StateArrayPtr states = astar::ReedsSheppModel::DiscretizeRS(s, path, inverse_unit, 0.05);
+
+        const astar::State2D &end(states->states.back());
+
+        if (1e-6 < end.position.Norm() || 1e-6 < std::fabs(std::remainder(end.orientation, pi2)))
+        {
+            missed += 1;
+        }
+
+        delete states;
+        delete path;
+
+        // the lateral neighbor
+        astar::Pose2D n(s.position.x - 0.01 * std::sin(s.orientation), s.position.y + 0.01 * std::cos(s.orientation), s.orientation);
+
+        double jump = std::fabs(rs.Distance(s, origin, inverse_unit) - rs.Distance(n, origin, inverse_unit));
+
+        max_jump = std::max(max_jump, jump);
+
+        if (0.5 < jump)
+        {
+            jumps += 1;
+        }
+    }
+
+    std::cout << "\n" << N << " random paths: " << missed << " don't end at the goal, " << jumps
+              << " cost jumps above 0.5 m between poses 1 cm apart, max difference " << max_jump << std::endl;
+
 	return 0;
 }
@@ -0,0 +1,274 @@
+#ifndef MOTION_PRIMITIVE_TABLE_HPP
+#define MOTION_PRIMITIVE_TABLE_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "../Entities/Pose2D.hpp"
+#include "../Entities/VehicleFootprint.hpp"
+#include "../Helpers/wrap2pi.hpp"
+
+namespace astar {
+
+    // the precomputed HybridAstar expansions, one primitive for each steering, gear and length class
+    // the moves are tabulated in the vehicle frame and rotated with the heading bins cos and sin table,
+    // so an expansion is a few lookups and products, there's no trig
+    // the node heading is rounded to the closest bin, each primitive keeps the resulting position error
+    class MotionPrimitiveTable {
+
+        public:
+
+            // a pose relative to the expanded node, in the vehicle frame
+            class Delta {
+
+                public:
+
+                    // the relative position
+                    double x, y;
+
+                    // the heading change
+                    double angle;
+
+            };
+
+            // a single primitive
+            class Primitive {
+
+                public:
+
+                    // the steering move
+                    astar::Steer steer;
+
+                    // the move length
+                    double length;
+
+                    // the end pose
+                    Delta end;
+
+                    // the intermediate poses along the arc, the start and end poses excluded
+                    // the conservative advancement skips the poses covered by the current clearance
+                    std::vector<Delta> swept;
+
+                    // the arc length between two consecutive poses
+                    double spacing;
+
+                    // the largest position error caused by the heading bins
+                    double position_error;
+
+            };
+
+            // the number of length classes, each one is 2^(1/4) times longer than the previous one
+            static const unsigned int NumLengthClasses = 24;
+
+            // the number of heading bins, the same as the footprint table
+            static const unsigned int HeadingBins = astar::VehicleFootprint::HeadingBins;
+
+        private:
+
+            // PRIVATE ATTRIBUTES
+
+            // the primitives, indexed by length class, gear and steering
+            std::vector<Primitive> primitives;
+
+            // the heading bins rotation
+            std::vector<double> cos_table, sin_table;
+
+            // the length of each class
+            double lengths[NumLengthClasses];
+
+            // the table parameters
+            double min_length, turn_radius, sample_step;
+
+            // PRIVATE METHODS
+
+            // the relative move, the same geometry as VehicleModel::NextPose
+            static Delta Move(astar::Steer steer, astar::Gear gear, double length, double radius) {
+
+                Delta d;
+
+                if (astar::RSStraight != steer) {
+
+                    double angle = length / radius;
+                    double angle2 = angle / 2;
+                    double sin_angle_2 = std::sin(angle2);
+                    double L = 2 * sin_angle_2 * radius;
+
+                    d.x = L * std::cos(angle2);
+                    d.y = L * sin_angle_2;
+                    d.angle = angle;
+
+                    if (astar::RSTurnRight == steer) {
+
+                        d.y = -d.y;
+                        d.angle = -d.angle;
+
+                    }
+
+                } else {
+
+                    d.x = length;
+                    d.y = 0.0;
+                    d.angle = 0.0;
+
+                }
+
+                if (astar::BackwardGear == gear) {
+
+                    d.x = -d.x;
+                    d.angle = -d.angle;
+
+                }
+
+                return d;
+
+            }
+
+        public:
+
+            // PUBLIC METHODS
+
+            // basic constructor, the table is empty until the first Build
+            MotionPrimitiveTable() : primitives(), cos_table(), sin_table(), min_length(0.0), turn_radius(0.0), sample_step(0.0) {}
+
+            // is the table built with the given parameters?
+            bool Matches(double min_length_, double turn_radius_, double sample_step_) const {
+
+                return !primitives.empty() && min_length == min_length_ && turn_radius == turn_radius_ && sample_step == sample_step_;
+
+            }
+
+            // build the table, the shortest length class is min_length and the swept poses are sample_step apart
+            void Build(double min_length_, double turn_radius_, double sample_step_) {
+
+                min_length = min_length_;
+                turn_radius = turn_radius_;
+                sample_step = sample_step_;
+
+                // the heading bins rotation
+                cos_table.resize(HeadingBins);
+                sin_table.resize(HeadingBins);
+
+                for (unsigned int b = 0; b < HeadingBins; ++b) {
+
+                    double heading = b * (2.0 * M_PI / HeadingBins);
+
+                    cos_table[b] = std::cos(heading);
+                    sin_table[b] = std::sin(heading);
+
+                }
+
+                // the chord between a heading and the closest bin, per unit of distance
+                double chord = 2.0 * std::sin(M_PI / (2.0 * HeadingBins));
+
+                primitives.resize(NumLengthClasses * astar::NumGears * astar::NumSteering);
+
+                for (unsigned int k = 0; k < NumLengthClasses; ++k) {
+
+                    lengths[k] = min_length * std::pow(2.0, k * 0.25);
+
+                    // how many intermediate poses
+                    unsigned int samples = static_cast<unsigned int>(std::ceil(lengths[k] / sample_step));
+
+                    for (unsigned int g = 0; g < astar::NumGears; ++g) {
+
+                        for (unsigned int s = 0; s < astar::NumSteering; ++s) {
+
+                            Primitive &p(primitives[(k * astar::NumGears + g) * astar::NumSteering + s]);
+
+                            astar::Steer steer = static_cast<astar::Steer>(s);
+                            astar::Gear gear = static_cast<astar::Gear>(g);
+
+                            p.steer = steer;
+                            p.length = lengths[k];
+                            p.end = Move(steer, gear, lengths[k], turn_radius);
+                            p.swept.clear();
+                            p.spacing = lengths[k] / samples;
+
+                            // the farthest pose, the end pose for any arc shorter than a half turn
+                            double farthest = std::sqrt(p.end.x * p.end.x + p.end.y * p.end.y);
+
+                            for (unsigned int i = 1; i < samples; ++i) {
+
+                                p.swept.push_back(Move(steer, gear, lengths[k] * i / samples, turn_radius));
+
+                                const Delta &d(p.swept.back());
+                                farthest = std::max(farthest, std::sqrt(d.x * d.x + d.y * d.y));
+
+                            }
+
+                            p.position_error = chord * farthest;
+
+                        }
+
+                    }
+
+                }
+
+            }
+
+            // get the closest length class to a given length, the classes are compared in the log scale
+            // the lengths outside the table range get the shortest or the longest class
+            unsigned int LengthClass(double length) const {
+
+                unsigned int k = std::upper_bound(lengths, lengths + NumLengthClasses, length) - lengths;
+
+                if (0 == k) {
+
+                    return 0;
+
+                }
+
+                if (NumLengthClasses == k) {
+
+                    return NumLengthClasses - 1;
+
+                }
+
+                // the geometric mean splits two consecutive classes
+                return length * length < lengths[k - 1] * lengths[k] ? k - 1 : k;
+
+            }
+
+            // get the length of a given class
+            double Length(unsigned int length_class) const {
+
+                return lengths[length_class];
+
+            }
+
+            // get a primitive
+            const Primitive& Get(astar::Steer steer, astar::Gear gear, unsigned int length_class) const {
+
+                return primitives[(length_class * astar::NumGears + gear) * astar::NumSteering + steer];
+
+            }
+
+            // get the heading bin closest to a given orientation, any orientation value is accepted
+            unsigned int HeadingBin(double orientation) const {
+
+                return static_cast<unsigned int>(static_cast<long>(std::floor(orientation * (HeadingBins / (2.0 * M_PI)) + 0.5))) & (HeadingBins - 1);
+
+            }
+
+            // get the position of a relative pose, the rotation comes from the start heading bin
+            astar::Vector2D<double> Position(const astar::Pose2D &start, unsigned int bin, const Delta &d) const {
+
+                return astar::Vector2D<double>(
+                        start.position.x + d.x * cos_table[bin] - d.y * sin_table[bin],
+                        start.position.y + d.x * sin_table[bin] + d.y * cos_table[bin]);
+
+            }
+
+            // get the end pose of a primitive
+            astar::Pose2D EndPose(const astar::Pose2D &start, unsigned int bin, const Primitive &p) const {
+
+                return astar::Pose2D(Position(start, bin, p.end), mrpt::math::wrapToPi<double>(start.orientation + p.end.angle));
+
+            }
+
+    };
+
+}
+
+#endif
@@ -33,6 +33,12 @@ void VehicleModel::Configure()
     // the circle radius
     circle_radius = 1.5;
 
+    // the body circles, spread along the vehicle length
+    if (0 < length)
+        footprint.Build(length, rear_car_wheels_dist, 4, circle_radius);
+    else
+        footprint = VehicleFootprint();
+
 }
 
 // get the next pose with Pose, Steer, Gear, length and custom turn radius
@@ -96,6 +102,66 @@ astar::Pose2D VehicleModel::NextPose(const astar::Pose2D &current_pose, Steer st
     return Pose2D(position + current_pose.position, mrpt::math::wrapToPi<double>(current_pose.orientation + angle));
 }
 
+// get the next poses of all the steering moves at once
+void VehicleModel::NextPoses(const astar::Pose2D &current_pose, Gear gear, double length, double t_radius, astar::Pose2D *poses) const
+{
+    // the turning move, the same for both sides
+    double angle = length/t_radius;
+
+    double angle2 = angle/2;
+
+    double sin_angle_2 = std::sin(angle2);
+
+    double L = 2*sin_angle_2*t_radius;
+
+    // the turning displacement
+    double tx = L*std::cos(angle2);
+    double ty = L*sin_angle_2;
+
+    // the straight displacement
+    double sx = length;
+
+    if (astar::BackwardGear == gear)
+    {
+        // change direction
+        tx = -tx;
+        sx = -sx;
+        angle = -angle;
+    }
+
+    // the current heading
+    double c = std::cos(current_pose.orientation);
+    double s = std::sin(current_pose.orientation);
+
+    for (unsigned int j = 0; j < astar::NumSteering; ++j)
+    {
+        // casting the steering
+        Steer steer = static_cast<Steer>(j);
+
+        // the relative move
+        double x = tx, y = ty, a = angle;
+
+        if (astar::RSStraight == steer)
+        {
+            // just a straight movement, no turning radius
+            x = sx;
+            y = 0.0;
+            a = 0.0;
+        }
+        else if (astar::RSTurnRight == steer)
+        {
+            // change direction
+            y = -y;
+            a = -a;
+        }
+
+        // rotate around z axis and move the point to the appropriated result
+        poses[j].position.x = current_pose.position.x + x*c - y*s;
+        poses[j].position.y = current_pose.position.y + x*s + y*c;
+        poses[j].orientation = mrpt::math::wrapToPi<double>(current_pose.orientation + a);
+    }
+}
+
 // get the next pose
 Pose2D VehicleModel::NextPose(const astar::Pose2D &current, double vel, double phi, double time) const {
 
@@ -192,14 +258,10 @@ std::vector<Circle> VehicleModel::GetVehicleBodyCircles(const astar::Vector2D<do
     // the output array
     std::vector<Circle> body;
 
-    // TODO get the values in a dynamic manner
-    // the circle radius = 1.25 m / resolution
-    double x_position[4] = {-0.36, 0.760, 1.880, 3.00};
-
-    for (unsigned int i = 0; i < 4; ++i)
+    for (unsigned int i = 0; i < footprint.size; ++i)
     {
         // set the current position
-        astar::Vector2D<double> position(x_position[i], 0);
+        astar::Vector2D<double> position(footprint.offsets[i], 0);
 
         // rotate the current position, follow the car heading
         position.RotateZ(orientation);
@@ -208,7 +270,7 @@ std::vector<Circle> VehicleModel::GetVehicleBodyCircles(const astar::Vector2D<do
         position.Add(p);
 
         // append the the circle to the body vector
-        body.push_back(astar::Circle(position, circle_radius));
+        body.push_back(astar::Circle(position, footprint.radius));
     }
 
     return body;
@@ -217,28 +279,7 @@ std::vector<Circle> VehicleModel::GetVehicleBodyCircles(const astar::Vector2D<do
 // get the list of circles that represents the safe area
 std::vector<Circle> VehicleModel::GetVehicleBodyCircles(const astar::Pose2D &p)
 {
-    // the output array
-    std::vector<Circle> body;
-
-    // TODO move to the class and get the values in a dynamic manner
-    double x_position[4] = {-0.36, 0.760, 1.880, 3.00};
-
-    for (unsigned int i = 0; i < 4; ++i)
-    {
-        // set the current position
-        astar::Vector2D<double> position(x_position[i], 0);
-
-        // rotate the current position, follow the car heading
-        position.RotateZ(p.orientation);
-
-        // move the current position to the car frame
-        position.Add(p.position);
-
-        // append the the circle to the body vector
-        body.push_back(astar::Circle(position, circle_radius));
-    }
-
-    return body;
+    return GetVehicleBodyCircles(p.position, p.orientation);
 }
 
 // get the desired wheel angle that connects two states
@@ -29,6 +29,7 @@
 #include "../ReedsShepp/ReedsSheppAction.hpp"
 #include "../PathFinding/HybridAstar/HybridAstarNode.hpp"
 #include "../Entities/Circle.hpp"
+#include "../Entities/VehicleFootprint.hpp"
 
 namespace astar {
 
@@ -133,6 +134,9 @@ class VehicleModel
         // the time to change the gears
         double change_gear_time;
 
+        // the vehicle body circles, built from the vehicle dimensions
+        astar::VehicleFootprint footprint;
+
         // PUBLIC METHODS
 
         // Configure the current vehicle model
@@ -147,6 +151,10 @@ class VehicleModel
         // get the next pose
         astar::Pose2D NextPose(const astar::Pose2D&, double vel, double phi, double time) const;
 
+        // get the next poses of all the steering moves at once, the output must hold NumSteering poses
+        // same result as NextPose for each steering, but the trig is computed once
+        void NextPoses(const astar::Pose2D&, astar::Gear, double length, double radius, astar::Pose2D *poses) const;
+
         // get the next state
         astar::State2D NextState(const astar::State2D&) const;
 
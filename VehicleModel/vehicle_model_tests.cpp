@@ -1,6 +1,10 @@
 #include <iostream>
+#include <cmath>
+#include <vector>
+#include <algorithm>
 
 #include "VehicleModel.hpp"
+#include "MotionPrimitiveTable.hpp"
 
 double
 get_phi_from_curvature(double curvature, double v, double understeer_coeficient, double distance_between_front_and_rear_axles)
@@ -139,6 +143,104 @@ int main () {
 	//
 	std::cout << "\nDone!\n";
 
+	// the footprint built from the vehicle dimensions, the old hard coded one was {3.00, -0.36, 1.88, 0.76}
+	std::cout << "The footprint circles after Configure():";
+	for (unsigned int i = 0; i < vehicle.footprint.size; ++i)
+	{
+		std::cout << " " << vehicle.footprint.offsets[i];
+	}
+	std::cout << " with radius: " << vehicle.footprint.radius << "\n";
+
+	// the tabulated offsets must stay within the heading error of the rotated body circles,
+	// on the bin headings and in between them
+	unsigned int footprint_failures = 0;
+	double max_footprint_error = 0.0;
+	double bin_step = 2.0 * M_PI / astar::VehicleFootprint::HeadingBins;
+	unsigned int bins[] = {0, 1, 127, 256, 511, 512, 777, astar::VehicleFootprint::HeadingBins - 1};
+	double fractions[] = {0.0, 0.25, -0.49, 0.49};
+
+	for (unsigned int b = 0; b < sizeof(bins) / sizeof(bins[0]); ++b)
+	{
+		for (unsigned int f = 0; f < sizeof(fractions) / sizeof(fractions[0]); ++f)
+		{
+			// the negative headings must land on the same bins
+			double heading = (bins[b] + fractions[f]) * bin_step - (1 == (b & 1) ? 2.0 * M_PI : 0.0);
+
+			std::vector<astar::Circle> body(vehicle.GetVehicleBodyCircles(pose.position, heading));
+			const double *rotated = vehicle.footprint.GetRotatedOffsets(heading);
+
+			for (unsigned int i = 0; i < vehicle.footprint.size; ++i)
+			{
+				double dx = pose.position.x + rotated[2 * i] - body[i].position.x;
+				double dy = pose.position.y + rotated[2 * i + 1] - body[i].position.y;
+				double error = std::sqrt(dx * dx + dy * dy);
+
+				max_footprint_error = std::max(max_footprint_error, error);
+
+				if (vehicle.footprint.heading_error + 1e-9 < error)
+				{
+					++footprint_failures;
+				}
+			}
+		}
+	}
+
+	std::cout << "The footprint table: " << footprint_failures << " circles past the heading error " << vehicle.footprint.heading_error;
+	std::cout << ", max error: " << max_footprint_error << "\n";
+
+	// the primitive end and swept poses must stay within the position error of the vehicle model moves,
+	// the same resolution and sample step as the search
+	astar::MotionPrimitiveTable primitives;
+	primitives.Build(0.2, vehicle.min_turn_radius, 0.1);
+
+	unsigned int primitive_failures = 0;
+	double max_primitive_error = 0.0, max_primitive_ratio = 0.0;
+	double headings[] = {0.0, 0.43, -1.2345, M_PI - 0.001, -M_PI + 0.0007, 2.5 * bin_step, 5.0};
+
+	for (unsigned int h = 0; h < sizeof(headings) / sizeof(headings[0]); ++h)
+	{
+		astar::Pose2D start(pose.position, headings[h]);
+		unsigned int bin = primitives.HeadingBin(start.orientation);
+
+		for (unsigned int k = 0; k < astar::MotionPrimitiveTable::NumLengthClasses; ++k)
+		{
+			for (unsigned int gear = 0; gear < astar::NumGears; ++gear)
+			{
+				for (unsigned int s = 0; s < astar::NumSteering; ++s)
+				{
+					const astar::MotionPrimitiveTable::Primitive &p(primitives.Get(static_cast<astar::Steer>(s), static_cast<astar::Gear>(gear), k));
+
+					// the end pose
+					astar::Pose2D end(primitives.EndPose(start, bin, p));
+					astar::Pose2D expected(vehicle.NextPose(start, p.steer, static_cast<astar::Gear>(gear), p.length, vehicle.min_turn_radius));
+
+					double error = end.position.Distance(expected.position);
+					double heading = std::fabs(mrpt::math::angDistance<double>(end.orientation, expected.orientation));
+
+					// the swept poses, the same moves over the intermediate lengths
+					for (unsigned int i = 0; i < p.swept.size(); ++i)
+					{
+						astar::Pose2D sample(vehicle.NextPose(start, p.steer, static_cast<astar::Gear>(gear), p.spacing * (i + 1), vehicle.min_turn_radius));
+
+						error = std::max(error, primitives.Position(start, bin, p.swept[i]).Distance(sample.position));
+						heading = std::max(heading, std::fabs(mrpt::math::angDistance<double>(start.orientation + p.swept[i].angle, sample.orientation)));
+					}
+
+					max_primitive_error = std::max(max_primitive_error, error);
+					max_primitive_ratio = std::max(max_primitive_ratio, error / p.position_error);
+
+					if (p.position_error + 1e-9 < error || 1e-9 < heading)
+					{
+						++primitive_failures;
+					}
+				}
+			}
+		}
+	}
+
+	std::cout << "The motion primitives: " << primitive_failures << " primitives past the position error, max error: " << max_primitive_error;
+	std::cout << ", max error to bound ratio: " << max_primitive_ratio << "\n";
+
 	std::cout << "The pose: " << pose.position.x << ", " << pose.position.y << ", " << pose.orientation << "\n";
 	next_pose = vehicle.NextPose(pose, steer, g, 1.0);
 	std::cout << "The next pose: " << next_pose.position.x << ", " << next_pose.position.y << ", " << next_pose.orientation << "\n";
@@ -167,5 +269,5 @@ int main () {
 	std::cout << "The next pose: " << next_pose.position.x << ", " << next_pose.position.y << ", " << next_pose.orientation << "\n";
 	std::cout << "The diff: " << pose.position.Distance(next_pose.position) << "\n";
 
-	return 0;
+	return 0 == footprint_failures && 0 == primitive_failures ? 0 : 1;
 }